@@ -25,62 +25,81 @@ void bidirectional_stream_copy(Socket &socket) {
     _input.set_blocking(false);
     _output.set_blocking(false);
 
+    // Each rule is polled only while its Arm is set. A rule disarms itself when it has drained
+    // (or filled) its stream, and the stream's watermark callbacks re-arm it when that changes,
+    // so the event loop never has to re-evaluate the streams on a wakeup.
+
     // rule 1: read from stdin into outbound byte stream
-    _eventloop.add_rule(
+    EventLoop::Arm stdin_arm = _eventloop.add_armed_rule(
         _input,
         Direction::In,
         [&] {
-            _outbound.write(_input.read(_outbound.remaining_capacity()));
+            _outbound.write_from(_input, _outbound.remaining_capacity());
             if (_input.eof()) {
                 _outbound.end_input();
             }
+            if (_outbound.remaining_capacity() == 0) {
+                stdin_arm.disarm();
+            }
         },
-        [&] { return (not _outbound.error()) and (_outbound.remaining_capacity() > 0) and (not _inbound.error()); },
+        true,
         [&] { _outbound.end_input(); });
 
     // rule 2: read from outbound byte stream into socket
-    _eventloop.add_rule(socket,
-                        Direction::Out,
-                        [&] {
-                            const size_t bytes_to_write = min(max_copy_length, _outbound.buffer_size());
-                            const size_t bytes_written = socket.write(_outbound.peek_output(bytes_to_write), false);
-                            _outbound.pop_output(bytes_written);
-                            if (_outbound.eof()) {
-                                socket.shutdown(SHUT_WR);
-                                _outbound_shutdown = true;
-                            }
-                        },
-                        [&] { return (not _outbound.buffer_empty()) or (_outbound.eof() and not _outbound_shutdown); },
-                        [&] { _outbound.end_input(); });
+    EventLoop::Arm socket_out_arm = _eventloop.add_armed_rule(
+        socket,
+        Direction::Out,
+        [&] {
+            _outbound.read_into(socket, max_copy_length);
+            if (_outbound.eof()) {
+                socket.shutdown(SHUT_WR);
+                _outbound_shutdown = true;
+            }
+            if (_outbound.buffer_empty()) {
+                socket_out_arm.disarm();
+            }
+        },
+        false,
+        [&] { _outbound.end_input(); });
 
     // rule 3: read from socket into inbound byte stream
-    _eventloop.add_rule(
+    EventLoop::Arm socket_in_arm = _eventloop.add_armed_rule(
         socket,
         Direction::In,
         [&] {
-            _inbound.write(socket.read(_inbound.remaining_capacity()));
+            _inbound.write_from(socket, _inbound.remaining_capacity());
             if (socket.eof()) {
                 _inbound.end_input();
             }
+            if (_inbound.remaining_capacity() == 0) {
+                socket_in_arm.disarm();
+            }
         },
-        [&] { return (not _inbound.error()) and (_inbound.remaining_capacity() > 0) and (not _outbound.error()); },
+        true,
         [&] { _inbound.end_input(); });
 
     // rule 4: read from inbound byte stream into stdout
-    _eventloop.add_rule(_output,
-                        Direction::Out,
-                        [&] {
-                            const size_t bytes_to_write = min(max_copy_length, _inbound.buffer_size());
-                            const size_t bytes_written = _output.write(_inbound.peek_output(bytes_to_write), false);
-                            _inbound.pop_output(bytes_written);
+    EventLoop::Arm stdout_arm = _eventloop.add_armed_rule(
+        _output,
+        Direction::Out,
+        [&] {
+            _inbound.read_into(_output, max_copy_length);
+
+            if (_inbound.eof()) {
+                _output.close();
+                _inbound_shutdown = true;
+            }
+            if (_inbound.buffer_empty()) {
+                stdout_arm.disarm();
+            }
+        },
+        false,
+        [&] { _inbound.end_input(); });
 
-                            if (_inbound.eof()) {
-                                _output.close();
-                                _inbound_shutdown = true;
-                            }
-                        },
-                        [&] { return (not _inbound.buffer_empty()) or (_inbound.eof() and not _inbound_shutdown); },
-                        [&] { _inbound.end_input(); });
+    _outbound.on_writable([&] { stdin_arm.arm(); });
+    _outbound.on_readable([&] { socket_out_arm.arm(); });
+    _inbound.on_writable([&] { socket_in_arm.arm(); });
+    _inbound.on_readable([&] { stdout_arm.arm(); });
 
     // loop until completion
     while (true) {
@@ -1,3 +1,4 @@
+#include "congestion_control.hh"
 #include "tcp_connection.hh"
 
 #include <chrono>
@@ -5,12 +6,16 @@
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <vector>
 
 using namespace std;
 using namespace std::chrono;
 
 constexpr size_t len = 100 * 1024 * 1024;
 
+//! Each pass through the loop below is one round trip of this many milliseconds
+constexpr size_t tick_ms = 1;
+
 void move_segments(TCPConnection &x, TCPConnection &y, vector<TCPSegment> &segments, const bool reorder) {
     while (not x.segments_out().empty()) {
         segments.emplace_back(move(x.segments_out().front()));
@@ -28,8 +33,9 @@ void move_segments(TCPConnection &x, TCPConnection &y, vector<TCPSegment> &segme
     segments.clear();
 }
 
-void main_loop(const bool reorder) {
+void main_loop(const bool reorder, const CongestionControl::Algorithm algorithm, const string &algorithm_name) {
     TCPConfig config;
+    config.congestion_control = algorithm;
     TCPConnection x{config}, y{config};
 
     string string_to_send(len, 'x');
@@ -72,12 +78,14 @@ void main_loop(const bool reorder) {
         // read output from y
         const auto available_output = y.inbound_stream().buffer_size();
         if (available_output > 0) {
-            string_received.append(y.inbound_stream().read(available_output));
+            const auto [first, second] = y.inbound_stream().peek_spans(available_output);
+            string_received.append(first).append(second);
+            y.inbound_stream().pop_output(first.size() + second.size());
         }
 
         // time passes
-        x.tick(1000);
-        y.tick(1000);
+        x.tick(tick_ms);
+        y.tick(tick_ms);
     };
 
     while (not y.inbound_stream().eof()) {
@@ -95,18 +103,31 @@ void main_loop(const bool reorder) {
     const auto gigabits_per_second = len * 8.0 / double(duration);
 
     cout << fixed << setprecision(2);
-    cout << "CPU-limited throughput" << (reorder ? " with reordering: " : "                : ") << gigabits_per_second
-         << " Gbit/s\n";
+    cout << "CPU-limited throughput" << (reorder ? " with reordering" : "                ") << " (" << setw(5)
+         << algorithm_name << "): " << gigabits_per_second << " Gbit/s\n";
 
     while (x.active() or y.active()) {
         loop();
     }
 }
 
-int main() {
+int main(int argc, char *argv[]) {
     try {
-        main_loop(false);
-        main_loop(true);
+        // optional arguments name the congestion-control algorithms to compare (default: none)
+        vector<string> algorithm_names{argv + 1, argv + argc};
+        if (algorithm_names.empty()) {
+            algorithm_names.emplace_back("none");
+        }
+
+        for (const auto &name : algorithm_names) {
+            const auto algorithm = CongestionControl::algorithm_from_name(name);
+            if (not algorithm.has_value()) {
+                cerr << "Usage: " << argv[0] << " [none|reno|cubic|bbr]...\n";
+                return EXIT_FAILURE;
+            }
+            main_loop(false, *algorithm, name);
+            main_loop(true, *algorithm, name);
+        }
     } catch (const exception &e) {
         cerr << e.what() << "\n";
         return EXIT_FAILURE;
@@ -29,6 +29,10 @@ static void show_usage(const char *argv0, const char *msg) {
          << "   -w <winsz>      Use a window of <winsz> bytes                   " << TCPConfig::MAX_PAYLOAD_SIZE
          << "\n\n"
 
+         << "   -M <mss>        Send segments of up to <mss> payload bytes      " << TCPConfig::MAX_PAYLOAD_SIZE << "\n"
+         << "   -m <mtu>        Send datagrams of up to <mtu> bytes             " << FdAdapterConfig::DEFAULT_MTU
+         << "\n\n"
+
          << "   -t <tmout>      Set rt_timeout to tmout                         " << TCPConfig::TIMEOUT_DFLT << "\n\n"
 
          << "   -d <tapdev>     Connect to tap <tapdev>                         " << TAP_DFLT << "\n\n"
@@ -48,6 +52,19 @@ static void check_argc(int argc, char **argv, int curr, const char *err) {
     }
 }
 
+//! Parses the argument of a size option, which must be a number from `min` to 65535
+static uint16_t parse_size(char **argv, int curr, const size_t min) {
+    char *end = nullptr;
+    const unsigned long value = strtoul(argv[curr + 1], &end, 0);
+    if (*end != '\0' or value < min or value > UINT16_MAX) {
+        const string err = "ERROR: " + string(argv[curr]) + " requires a number from " + to_string(min) + " to " +
+                           to_string(UINT16_MAX) + ".";
+        show_usage(argv[0], err.c_str());
+        exit(1);
+    }
+    return static_cast<uint16_t>(value);
+}
+
 static tuple<TCPConfig, FdAdapterConfig, Address, string> get_config(int argc, char **argv) {
     TCPConfig c_fsm{};
     FdAdapterConfig c_filt{};
@@ -80,6 +97,17 @@ static tuple<TCPConfig, FdAdapterConfig, Address, string> get_config(int argc, c
             c_fsm.recv_capacity = strtol(argv[curr + 1], nullptr, 0);
             curr += 2;
 
+        } else if (strncmp("-M", argv[curr], 3) == 0) {
+            check_argc(argc, argv, curr, "ERROR: -M requires one argument.");
+            c_fsm.mss = parse_size(argv, curr, 1);
+            curr += 2;
+
+        } else if (strncmp("-m", argv[curr], 3) == 0) {
+            check_argc(argc, argv, curr, "ERROR: -m requires one argument.");
+            // room for the headers and at least one byte of payload
+            c_filt.mtu = parse_size(argv, curr, IPv4Header::LENGTH + TCPHeader::LENGTH + 1);
+            curr += 2;
+
         } else if (strncmp("-t", argv[curr], 3) == 0) {
             check_argc(argc, argv, curr, "ERROR: -t requires one argument.");
             c_fsm.rt_timeout = strtol(argv[curr + 1], nullptr, 0);
@@ -126,8 +154,8 @@ int main(int argc, char **argv) {
 
         auto [c_fsm, c_filt, next_hop, tap_dev_name] = get_config(argc, argv);
 
-        TCPOverIPv4OverEthernetSpongeSocket tcp_socket(TCPOverIPv4OverEthernetAdapter(
-            TCPOverIPv4OverEthernetAdapter(TapFD(tap_dev_name), local_ethernet_address, c_filt.source, next_hop)));
+        TCPOverIPv4OverEthernetSpongeSocket tcp_socket(TCPOverIPv4OverEthernetAdapter(TCPOverIPv4OverEthernetAdapter(
+            TapFD(tap_dev_name), local_ethernet_address, c_filt.source, next_hop, c_filt.mtu)));
 
         tcp_socket.connect(c_fsm, c_filt);
 
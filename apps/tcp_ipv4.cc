@@ -30,8 +30,28 @@ static void show_usage(const char *argv0, const char *msg) {
          << "   -w <winsz>      Use a window of <winsz> bytes                   " << TCPConfig::MAX_PAYLOAD_SIZE
          << "\n\n"
 
+         << "   -M <mss>        Send segments of up to <mss> payload bytes      " << TCPConfig::MAX_PAYLOAD_SIZE << "\n"
+         << "   -m <mtu>        Send datagrams of up to <mtu> bytes             " << FdAdapterConfig::DEFAULT_MTU
+         << "\n\n"
+
          << "   -t <tmout>      Set rt_timeout to tmout                         " << TCPConfig::TIMEOUT_DFLT << "\n\n"
 
+         << "   -R              Adapt the RTO to measured round-trip times      (off)\n"
+         << "   -F              Fast retransmit on duplicate ACKs               (off)\n\n"
+
+         << "   -S <bytes>      Spill stream buffers larger than <bytes> to a   (never)\n"
+         << "                   memory-mapped temporary file\n"
+         << "   -A              Autotune stream buffers, up to 4 MiB            (off)\n\n"
+
+         << "   -K              Negotiate selective acknowledgments (SACK)      (off)\n"
+         << "   -W              Negotiate window scaling                        (off)\n"
+         << "   -T              Negotiate timestamps (RTT samples and PAWS)     (off)\n\n"
+
+         << "   -C <algo>       Congestion control: none, reno, cubic or bbr    none\n"
+         << "   -P              Pace segments over the round trip               (off)\n"
+         << "   -E              Detect losses early (RACK-TLP)                  (off)\n"
+         << "   -D              Delay ACKs (every 2nd segment or 40 ms)         (off)\n\n"
+
          << "   -d <tundev>     Connect to tun <tundev>                         " << TUN_DFLT << "\n\n"
 
          << "   -Lu <loss>      Set uplink loss to <rate> (float in 0..1)       (no loss)\n"
@@ -52,6 +72,19 @@ static void check_argc(int argc, char **argv, int curr, const char *err) {
     }
 }
 
+//! Parses the argument of a size option, which must be a number from `min` to 65535
+static uint16_t parse_size(char **argv, int curr, const size_t min) {
+    char *end = nullptr;
+    const unsigned long value = strtoul(argv[curr + 1], &end, 0);
+    if (*end != '\0' or value < min or value > UINT16_MAX) {
+        const string err = "ERROR: " + string(argv[curr]) + " requires a number from " + to_string(min) + " to " +
+                           to_string(UINT16_MAX) + ".";
+        show_usage(argv[0], err.c_str());
+        exit(1);
+    }
+    return static_cast<uint16_t>(value);
+}
+
 static tuple<TCPConfig, FdAdapterConfig, bool, char *> get_config(int argc, char **argv) {
     TCPConfig c_fsm{};
     FdAdapterConfig c_filt{};
@@ -83,6 +116,68 @@ static tuple<TCPConfig, FdAdapterConfig, bool, char *> get_config(int argc, char
             c_fsm.recv_capacity = strtol(argv[curr + 1], nullptr, 0);
             curr += 2;
 
+        } else if (strncmp("-M", argv[curr], 3) == 0) {
+            check_argc(argc, argv, curr, "ERROR: -M requires one argument.");
+            c_fsm.mss = parse_size(argv, curr, 1);
+            curr += 2;
+
+        } else if (strncmp("-m", argv[curr], 3) == 0) {
+            check_argc(argc, argv, curr, "ERROR: -m requires one argument.");
+            // room for the headers and at least one byte of payload
+            c_filt.mtu = parse_size(argv, curr, IPv4Header::LENGTH + TCPHeader::LENGTH + 1);
+            curr += 2;
+
+        } else if (strncmp("-S", argv[curr], 3) == 0) {
+            check_argc(argc, argv, curr, "ERROR: -S requires one argument.");
+            c_fsm.spill_threshold = strtoull(argv[curr + 1], nullptr, 0);
+            curr += 2;
+
+        } else if (strncmp("-R", argv[curr], 3) == 0) {
+            c_fsm.adaptive_rto = true;
+            curr += 1;
+
+        } else if (strncmp("-F", argv[curr], 3) == 0) {
+            c_fsm.fast_retransmit = true;
+            curr += 1;
+
+        } else if (strncmp("-K", argv[curr], 3) == 0) {
+            c_fsm.sack = true;
+            curr += 1;
+
+        } else if (strncmp("-W", argv[curr], 3) == 0) {
+            c_fsm.window_scaling = true;
+            curr += 1;
+
+        } else if (strncmp("-T", argv[curr], 3) == 0) {
+            c_fsm.timestamps = true;
+            curr += 1;
+
+        } else if (strncmp("-P", argv[curr], 3) == 0) {
+            c_fsm.pacing = true;
+            curr += 1;
+
+        } else if (strncmp("-E", argv[curr], 3) == 0) {
+            c_fsm.rack_tlp = true;
+            curr += 1;
+
+        } else if (strncmp("-D", argv[curr], 3) == 0) {
+            c_fsm.delayed_ack = true;
+            curr += 1;
+
+        } else if (strncmp("-A", argv[curr], 3) == 0) {
+            c_fsm.autotune_buffers = true;
+            curr += 1;
+
+        } else if (strncmp("-C", argv[curr], 3) == 0) {
+            check_argc(argc, argv, curr, "ERROR: -C requires one argument.");
+            const auto algorithm = CongestionControl::algorithm_from_name(argv[curr + 1]);
+            if (not algorithm.has_value()) {
+                show_usage(argv[0], "ERROR: unknown congestion-control algorithm.");
+                exit(1);
+            }
+            c_fsm.congestion_control = *algorithm;
+            curr += 2;
+
         } else if (strncmp("-t", argv[curr], 3) == 0) {
             check_argc(argc, argv, curr, "ERROR: -t requires one argument.");
             c_fsm.rt_timeout = strtol(argv[curr + 1], nullptr, 0);
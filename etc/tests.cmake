@@ -30,12 +30,19 @@ add_test(NAME t_strm_reassem_many        COMMAND fsm_stream_reassembler_many)
 add_test(NAME t_strm_reassem_overlapping COMMAND fsm_stream_reassembler_overlapping)
 add_test(NAME t_strm_reassem_win         COMMAND fsm_stream_reassembler_win)
 add_test(NAME t_strm_reassem_cap         COMMAND fsm_stream_reassembler_cap)
+add_test(NAME t_strm_reassem_staged      COMMAND fsm_stream_reassembler_staged)
+add_test(NAME t_strm_reassem_fast_path   COMMAND fsm_stream_reassembler_fast_path)
+add_test(NAME t_interval_set             COMMAND interval_set)
 
 add_test(NAME t_byte_stream_construction COMMAND byte_stream_construction)
 add_test(NAME t_byte_stream_one_write    COMMAND byte_stream_one_write)
 add_test(NAME t_byte_stream_two_writes   COMMAND byte_stream_two_writes)
 add_test(NAME t_byte_stream_capacity     COMMAND byte_stream_capacity)
 add_test(NAME t_byte_stream_many_writes  COMMAND byte_stream_many_writes)
+add_test(NAME t_byte_stream_buffer_chain COMMAND byte_stream_buffer_chain)
+add_test(NAME t_byte_stream_fd           COMMAND byte_stream_fd)
+add_test(NAME t_byte_stream_watermarks   COMMAND byte_stream_watermarks)
+add_test(NAME t_byte_stream_spsc         COMMAND spsc_byte_stream)
 
 add_test(NAME t_webget               COMMAND "${PROJECT_SOURCE_DIR}/tests/webget_t.sh")
 
@@ -62,6 +69,21 @@ add_test(NAME t_retx_win             COMMAND fsm_retx_win)
 add_test(NAME t_loopback             COMMAND fsm_loopback)
 add_test(NAME t_loopback_win         COMMAND fsm_loopback_win)
 add_test(NAME t_reorder              COMMAND fsm_reorder)
+add_test(NAME t_sack                 COMMAND tcp_sack)
+add_test(NAME t_congestion_control   COMMAND congestion_control)
+add_test(NAME t_rtt_estimator        COMMAND rtt_estimator)
+add_test(NAME t_fast_retransmit      COMMAND fast_retransmit)
+add_test(NAME t_sack_recovery        COMMAND sack_recovery)
+add_test(NAME t_sender_zero_copy     COMMAND sender_zero_copy)
+add_test(NAME t_mss                  COMMAND tcp_mss)
+add_test(NAME t_window_scale         COMMAND tcp_window_scale)
+add_test(NAME t_timestamps           COMMAND tcp_timestamps)
+add_test(NAME t_pacing               COMMAND tcp_pacing)
+add_test(NAME t_timer_wheel          COMMAND timer_wheel)
+add_test(NAME t_rack_tlp             COMMAND tcp_rack_tlp)
+add_test(NAME t_delayed_ack          COMMAND tcp_delayed_ack)
+add_test(NAME t_autotune             COMMAND tcp_autotune)
+add_test(NAME t_window_update        COMMAND tcp_window_update)
 
 add_test(NAME t_address_dt           COMMAND address_dt)
 add_test(NAME t_parser_dt            COMMAND parser_dt)
@@ -1,6 +1,9 @@
 #include "byte_stream.hh"
 
+#include "file_descriptor.hh"
+
 #include <algorithm>
+#include <cstring>
 #include <stdexcept>
 // Dummy implementation of a flow-controlled in-memory byte stream.
 
@@ -14,39 +17,292 @@ void DUMMY_CODE(Targs &&... /* unused */) {}
 
 using namespace std;
 
-ByteStream::ByteStream(const size_t capacity) 
-    : _capacity(capacity), _input_ended(false), _error(false), _bytes_written(0), _bytes_read(0) {}
+//! \param[in] capacity the maximum number of unread bytes the stream will hold
+//! \param[in] storage whether to copy bytes into a ring buffer or keep them as shared Buffers
+ByteStream::ByteStream(const size_t capacity, const Storage storage)
+    : _storage(storage)
+    , _buffer(storage == Storage::Ring ? capacity : 0)
+    , _mapped(storage == Storage::MappedFile ? MappedTempFile(capacity) : MappedTempFile())
+    , _capacity(capacity)
+    , _input_ended(false)
+    , _error(false)
+    , _bytes_written(0)
+    , _bytes_read(0) {}
+
+//! \param[in] data bytes to copy into the ring; the caller has already checked that they fit
+//! \param[in] offset is the distance past the end of the unread bytes at which to put `data`
+void ByteStream::copy_into_ring(const string_view data, const size_t offset) {
+    if (data.empty()) {
+        return;
+    }
+
+    // copy in at most two pieces: up to the end of the storage, then wrapping around to the front
+    const size_t tail = (_head + _size + offset) % _capacity;
+    const size_t first_len = min(data.size(), _capacity - tail);
+    memcpy(ring() + tail, data.data(), first_len);
+    memcpy(ring(), data.data() + first_len, data.size() - first_len);
+}
+
+//! \param[in] src is a ring of `src_capacity` bytes to copy from, starting at `src_pos` and wrapping around
+//! \param[in] dst is a ring of `dst_capacity` bytes to copy to, starting at `dst_pos` and wrapping around
+//! \param[in] len is the number of bytes to copy
+static void copy_between_rings(const char *src, const size_t src_capacity, size_t src_pos,
+                               char *dst, const size_t dst_capacity, size_t dst_pos, size_t len) {
+    while (len > 0) {
+        const size_t chunk = min({len, src_capacity - src_pos, dst_capacity - dst_pos});
+        memcpy(dst + dst_pos, src + src_pos, chunk);
+        src_pos = (src_pos + chunk) % src_capacity;
+        dst_pos = (dst_pos + chunk) % dst_capacity;
+        len -= chunk;
+    }
+}
+
+//! \param[in] capacity is the new maximum number of unread bytes
+void ByteStream::set_capacity(const size_t capacity) {
+    if (capacity < _size) {
+        throw invalid_argument("ByteStream::set_capacity(): capacity is less than buffer_size()");
+    }
+    if (capacity == _capacity) {
+        return;
+    }
+
+    // the unread bytes, followed by whatever was staged in the free space that is left
+    const size_t keep = min(_capacity, capacity);
+    const size_t old_room = remaining_capacity();
+    if (_storage == Storage::Ring) {
+        vector<char> ring(capacity);
+        copy_between_rings(_buffer.data(), _capacity, _head, ring.data(), capacity, 0, keep);
+        _buffer = move(ring);
+        _head = 0;
+    } else if (_storage == Storage::MappedFile) {
+        MappedTempFile mapped(capacity);
+        copy_between_rings(_mapped.data(), _capacity, _head, mapped.data(), capacity, 0, keep);
+        _mapped = move(mapped);
+        _head = 0;
+    } else if (not _buffer.empty()) {
+        // staged bytes are indexed by their absolute position in the stream
+        vector<char> staged(capacity);
+        copy_between_rings(_buffer.data(),
+                           _capacity,
+                           _bytes_written % _capacity,
+                           staged.data(),
+                           capacity,
+                           _bytes_written % capacity,
+                           keep - _size);
+        _buffer = move(staged);
+    }
+    _capacity = capacity;
+
+    if (_writable.callback and old_room < _writable.level and remaining_capacity() >= _writable.level) {
+        _writable.callback();
+    }
+}
 
 size_t ByteStream::write(const string &data) {
     if(_input_ended || _error){
         return 0;
     }
 
-    const size_t available_capacity = remaining_capacity();
+    const size_t len_to_write = min(data.length(), remaining_capacity());
+    if (len_to_write == 0) {
+        return 0;
+    }
 
-    const size_t len_to_write = min(data.length(),available_capacity);
+    if (_storage == Storage::BufferChain) {
+        _chain.append(Buffer(data.substr(0, len_to_write)));
+    } else {
+        copy_into_ring({data.data(), len_to_write});
+    }
+
+    _size += len_to_write;
+    _bytes_written += len_to_write;
+    notify_watermarks(_size - len_to_write);
 
-    for(size_t i = 0; i < len_to_write; ++i){
-        _buffer.push_back(data[i]);
+    return len_to_write;
+}
+
+size_t ByteStream::write(const Buffer &data) {
+    if (_input_ended || _error) {
+        return 0;
     }
+
+    const size_t len_to_write = min(data.size(), remaining_capacity());
+    if (len_to_write == 0) {
+        return 0;
+    }
+
+    if (_storage == Storage::BufferChain) {
+        Buffer slice = data;
+        slice.remove_suffix(data.size() - len_to_write);
+        _chain.append(slice);
+    } else {
+        copy_into_ring(data.str().substr(0, len_to_write));
+    }
+
+    _size += len_to_write;
     _bytes_written += len_to_write;
+    notify_watermarks(_size - len_to_write);
 
     return len_to_write;
 }
 
+size_t ByteStream::write(const BufferList &data) {
+    size_t total_written = 0;
+    for (const auto &buf : data.buffers()) {
+        const size_t written = write(buf);
+        total_written += written;
+        if (written < buf.size()) {
+            break;
+        }
+    }
+    return total_written;
+}
+
+//! \param[in] fd the file descriptor to read from
+//! \param[in] limit the maximum number of bytes to read
+size_t ByteStream::write_from(FileDescriptor &fd, const size_t limit) {
+    if (_input_ended || _error) {
+        return 0;
+    }
+
+    const size_t len_to_read = min(limit, remaining_capacity());
+    if (len_to_read == 0) {
+        return 0;
+    }
+
+    if (_storage == Storage::BufferChain) {
+        return write(Buffer(fd.read(len_to_read)));
+    }
+
+    // read into the free space of the ring: up to the end of the storage, then from the front
+    const size_t tail = (_head + _size) % _capacity;
+    const size_t first_len = min(len_to_read, _capacity - tail);
+    vector<iovec> iovecs{{ring() + tail, first_len}};
+    if (len_to_read > first_len) {
+        iovecs.push_back({ring(), len_to_read - first_len});
+    }
+    const size_t bytes_read = fd.read(iovecs);
+
+    _size += bytes_read;
+    _bytes_written += bytes_read;
+    notify_watermarks(_size - bytes_read);
+
+    return bytes_read;
+}
+
+//! \param[in] offset is how far past the end of the stream `data` begins
+//! \param[in] data bytes to stage
+size_t ByteStream::stage(const size_t offset, const string_view data) {
+    if (_input_ended || _error || offset >= remaining_capacity()) {
+        return 0;
+    }
+
+    const size_t len_to_stage = min(data.size(), remaining_capacity() - offset);
+    if (_storage == Storage::BufferChain) {
+        // the chain has no free space to stage into; keep a ring indexed by absolute stream position
+        if (_buffer.empty()) {
+            _buffer.resize(_capacity);
+        }
+        const size_t pos = (_bytes_written + offset) % _capacity;
+        const size_t first_len = min(len_to_stage, _capacity - pos);
+        memcpy(_buffer.data() + pos, data.data(), first_len);
+        memcpy(_buffer.data(), data.data() + first_len, len_to_stage - first_len);
+    } else {
+        copy_into_ring(data.substr(0, len_to_stage), offset);
+    }
+    return len_to_stage;
+}
+
+//! \param[in] len is the number of staged bytes to append to the stream
+void ByteStream::commit(const size_t len) {
+    if (len > remaining_capacity()) {
+        throw invalid_argument("ByteStream::commit(): len is greater than remaining capacity");
+    }
+    if (len == 0 || _input_ended || _error) {
+        return;
+    }
+
+    if (_storage == Storage::BufferChain) {
+        const size_t pos = _bytes_written % _capacity;
+        const size_t first_len = min(len, _capacity - pos);
+        string bytes;
+        bytes.reserve(len);
+        bytes.append(_buffer.data() + pos, first_len).append(_buffer.data(), len - first_len);
+        _chain.append(Buffer(move(bytes)));
+    }
+
+    _size += len;
+    _bytes_written += len;
+    notify_watermarks(_size - len);
+}
+
 //! \param[in] len bytes will be copied from the output side of the buffer
 string ByteStream::peek_output(const size_t len) const {
-    const size_t len_to_peek = min(len,_buffer.size());
-    return string(_buffer.begin(),_buffer.begin() + len_to_peek);
+    const size_t len_to_peek = min(len, _size);
+    string result;
+    result.reserve(len_to_peek);
+
+    if (_storage == Storage::BufferChain) {
+        for (const auto &buf : _chain.buffers()) {
+            if (result.size() == len_to_peek) {
+                break;
+            }
+            result.append(buf.str().substr(0, len_to_peek - result.size()));
+        }
+        return result;
+    }
+
+    const auto [first, second] = peek_spans(len_to_peek);
+    result.append(first).append(second);
+    return result;
+}
+
+//! \param[in] len bytes will be exposed from the output side of the buffer
+pair<string_view, string_view> ByteStream::peek_spans(const size_t len) const {
+    const size_t len_to_peek = min(len, _size);
+
+    if (_storage == Storage::BufferChain) {
+        const auto &buffers = _chain.buffers();
+        if (buffers.empty()) {
+            return {};
+        }
+        const string_view first = buffers[0].str().substr(0, len_to_peek);
+        if (buffers.size() == 1) {
+            return {first, {}};
+        }
+        return {first, buffers[1].str().substr(0, len_to_peek - first.size())};
+    }
+
+    const size_t first_len = min(len_to_peek, _capacity - _head);
+    return {{ring() + _head, first_len}, {ring(), len_to_peek - first_len}};
 }
 
 //! \param[in] len bytes will be removed from the output side of the buffer
 void ByteStream::pop_output(const size_t len) { 
-    if(len > _buffer.size()){
+    if(len > _size){
         throw invalid_argument("ByteStream::pop_output(): len is greater than buffer size");
     }
-    _buffer.erase(_buffer.begin(),_buffer.begin() + len);
+    if (len == 0) {
+        return;
+    }
+    if (_storage == Storage::BufferChain) {
+        _chain.remove_prefix(len);
+    } else {
+        if (_storage == Storage::MappedFile) {
+            // the popped bytes will never be read again: let the kernel drop every page the head has now
+            // left entirely, instead of paging them out. That includes the page the head started in, back
+            // to its first byte, unless the writer has wrapped around into it.
+            const size_t behind = min(_head % MappedTempFile::page_size(), _capacity - _size);
+            const size_t start = _head - behind;
+            const size_t first_len = min(behind + len, _capacity - start);
+            _mapped.discard(start, first_len);
+            _mapped.discard(0, behind + len - first_len);
+        }
+        _head = (_head + len) % _capacity;
+    }
+    _size -= len;
     _bytes_read += len;
+    notify_watermarks(_size + len);
  }
 
 //! Read (i.e., copy and then pop) the next "len" bytes of the stream
@@ -59,8 +315,115 @@ std::string ByteStream::read(const size_t len) {
     return result;
 }
 
+//! \param[in] len bytes will be popped and returned
+//! \returns a BufferList holding the popped bytes
+BufferList ByteStream::read_buffers(const size_t len) {
+    const size_t len_to_read = min(len, _size);
+    if (_storage != Storage::BufferChain) {
+        BufferList result{peek_output(len_to_read)};
+        pop_output(len_to_read);
+        return result;
+    }
+
+    BufferList result;
+    size_t remaining = len_to_read;
+    for (const auto &buf : _chain.buffers()) {
+        if (remaining == 0) {
+            break;
+        }
+        Buffer slice = buf;
+        if (slice.size() > remaining) {
+            slice.remove_suffix(slice.size() - remaining);
+        }
+        remaining -= slice.size();
+        result.append(slice);
+    }
+    pop_output(len_to_read);
+    return result;
+}
+
+//! \param[in] len bytes will be popped and returned
+Buffer ByteStream::read_buffer(const size_t len) {
+    const size_t len_to_read = min(len, _size);
+    if (_storage != Storage::BufferChain or len_to_read == 0 or _chain.buffers().front().size() < len_to_read) {
+        return read(len_to_read);
+    }
+
+    Buffer slice = _chain.buffers().front();
+    slice.remove_suffix(slice.size() - len_to_read);
+    pop_output(len_to_read);
+    return slice;
+}
+
+//! \param[in] fd the file descriptor to write to
+//! \param[in] limit the maximum number of bytes to write
+size_t ByteStream::read_into(FileDescriptor &fd, const size_t limit) {
+    const auto [first, second] = peek_spans(limit);
+    if (first.empty()) {
+        return 0;
+    }
+    const size_t bytes_written = fd.write({first, second}, false);
+    pop_output(bytes_written);
+    return bytes_written;
+}
+
 void ByteStream::end_input() {
+    const bool was_ended = _input_ended;
     _input_ended = true;
+    if (not was_ended and _readable.callback) {
+        _readable.callback();
+    }
+}
+
+void ByteStream::set_error() {
+    const bool had_error = _error;
+    _error = true;
+    if (had_error) {
+        return;
+    }
+    // wake up both sides so they notice the error
+    if (_readable.callback) {
+        _readable.callback();
+    }
+    if (_writable.callback) {
+        _writable.callback();
+    }
+}
+
+//! \param[in] callback is called when the stream becomes readable
+//! \param[in] high_watermark is the number of buffered bytes that counts as readable
+void ByteStream::on_readable(function<void()> callback, const size_t high_watermark) {
+    _readable = {high_watermark, move(callback)};
+}
+
+//! \param[in] callback is called when the stream drains
+//! \param[in] low_watermark is the buffer size that the stream must fall below
+void ByteStream::on_drained(function<void()> callback, const size_t low_watermark) {
+    _drained = {low_watermark, move(callback)};
+}
+
+//! \param[in] callback is called when the stream has room
+//! \param[in] room is the number of free bytes that counts as writable
+void ByteStream::on_writable(function<void()> callback, const size_t room) {
+    _writable = {room, move(callback)};
+}
+
+//! \param[in] old_size is the value of buffer_size() before the change that is being reported
+void ByteStream::notify_watermarks(const size_t old_size) const {
+    if (_size > old_size) {
+        if (_readable.callback and old_size < _readable.level and _size >= _readable.level) {
+            _readable.callback();
+        }
+        return;
+    }
+
+    if (_drained.callback and old_size >= _drained.level and _size < _drained.level) {
+        _drained.callback();
+    }
+    const size_t old_room = _capacity - old_size;
+    if (_writable.callback and old_room < _writable.level and remaining_capacity() >= _writable.level) {
+        _writable.callback();
+    }
 }
 
 bool ByteStream::input_ended() const {
@@ -68,15 +431,15 @@ bool ByteStream::input_ended() const {
 }
 
 size_t ByteStream::buffer_size() const {
-    return _buffer.size();
+    return _size;
 }
 
 bool ByteStream::buffer_empty() const {
-    return _buffer.empty();
+    return _size == 0;
 }
 
 bool ByteStream::eof() const {
-    return _input_ended && _buffer.empty();
+    return _input_ended && _size == 0;
 }
 
 size_t ByteStream::bytes_written() const {
@@ -88,5 +451,5 @@ size_t ByteStream::bytes_read() const {
 }
 
 size_t ByteStream::remaining_capacity() const {
-    return _capacity - _buffer.size();
+    return _capacity - _size;
 }
@@ -1,10 +1,18 @@
 #ifndef SPONGE_LIBSPONGE_BYTE_STREAM_HH
 #define SPONGE_LIBSPONGE_BYTE_STREAM_HH
 
-#include <string>
-#include <deque>
+#include "buffer.hh"
+#include "mapped_temp_file.hh"
+
 #include <algorithm>
 #include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class FileDescriptor;
 
 //! \brief An in-order byte stream.
 
@@ -12,24 +20,60 @@
 //! side.  The byte stream is finite: the writer can end the input,
 //! and then no more bytes can be written.
 class ByteStream {
+  public:
+    //! How the stream holds its unread bytes
+    enum class Storage {
+        Ring,         //!< Bytes are copied into a fixed-size ring buffer
+        BufferChain,  //!< Bytes are kept as a chain of shared Buffer slices, without copying
+        MappedFile    //!< Like Ring, but the ring is a memory-mapped temporary file that can spill to disk
+    };
+
   private:
-    // Your code here -- add private members as necessary.
-    std::deque<char> _buffer{};
+    Storage _storage;
+
+    //! Fixed-size ring storage; the unread bytes start at `_head` and may wrap around the end.
+    //! In Storage::BufferChain mode this holds only staged bytes (see stage()), and is allocated on first use.
+    std::vector<char> _buffer{};
+    //! Ring storage when `_storage` is Storage::MappedFile
+    MappedTempFile _mapped{};
+    //! Unread bytes when `_storage` is Storage::BufferChain
+    BufferList _chain{};
+    size_t _head{};  //!< Offset in `_buffer` of the next byte to be read
+    size_t _size{};  //!< Number of unread bytes currently stored
 
     size_t _capacity{};
     bool _input_ended{};
-    
+
     bool _error{};  //!< Flag indicating that the stream suffered an error.
 
     size_t _bytes_written{};  //!< Total number of bytes written to the stream.
     size_t _bytes_read{};     //!< Total number of bytes read from the stream.
-    // Hint: This doesn't need to be a sophisticated data structure at
-    // all, but if any of your tests are taking longer than a second,
-    // that's a sign that you probably want to keep exploring
-    // different approaches.
+
+    //! \brief A callback that fires when a level is crossed in one direction
+    struct Watermark {
+        size_t level{};                    //!< the threshold, in bytes
+        std::function<void()> callback{};  //!< called when the threshold is crossed
+    };
+
+    Watermark _readable{};  //!< buffer_size() rose to at least `level`, or the stream ended or errored
+    Watermark _drained{};   //!< buffer_size() fell below `level`
+    Watermark _writable{};  //!< remaining_capacity() rose to at least `level`
+
+    //! Fire any watermark callbacks crossed since the buffer held `old_size` bytes
+    void notify_watermarks(const size_t old_size) const;
+
+    //! Copy `data` into the free space of the ring buffer, `offset` bytes past its end
+    void copy_into_ring(const std::string_view data, const size_t offset = 0);
+
+    //! \name Start of the ring storage (in memory or memory-mapped)
+    //!@{
+    char *ring() { return _storage == Storage::MappedFile ? _mapped.data() : _buffer.data(); }
+    const char *ring() const { return _storage == Storage::MappedFile ? _mapped.data() : _buffer.data(); }
+    //!@}
+
   public:
     //! Construct a stream with room for `capacity` bytes.
-    ByteStream(const size_t capacity);
+    ByteStream(const size_t capacity, const Storage storage = Storage::Ring);
 
     //! \name "Input" interface for the writer
     //!@{
@@ -39,14 +83,69 @@ class ByteStream {
     //! \returns the number of bytes accepted into the stream
     size_t write(const std::string &data);
 
+    //! Write a Buffer into the stream. Write as many bytes as will fit.
+    //! \note In Storage::BufferChain mode the bytes are shared with `data`, not copied.
+    //! \returns the number of bytes accepted into the stream
+    size_t write(const Buffer &data);
+
+    //! Write a BufferList into the stream. Write as many bytes as will fit.
+    //! \returns the number of bytes accepted into the stream
+    size_t write(const BufferList &data);
+
+    //! Read up to `limit` bytes from `fd` directly into the stream's storage
+    //! (a single [readv(2)](\ref man2::readv) in Storage::Ring mode).
+    //! \returns the number of bytes accepted into the stream
+    size_t write_from(FileDescriptor &fd, const size_t limit);
+
     //! \returns the number of additional bytes that the stream has space for
     size_t remaining_capacity() const;
 
+    //! \returns the maximum number of unread bytes the stream will hold
+    size_t capacity() const { return _capacity; }
+
+    //! \brief Change the maximum number of unread bytes the stream will hold
+    //! \details The unread bytes are kept, and so are the staged bytes (see stage()) that still lie within
+    //! the new free space; staged bytes beyond it are dropped. The ring storage is reallocated, so views
+    //! from peek_spans() are invalidated.
+    //! \throws std::invalid_argument if `capacity` is less than buffer_size()
+    void set_capacity(const size_t capacity);
+
+    //! \brief Copy bytes into the free space past the end of the stream without making them readable yet
+    //! \details `data` lands `offset` bytes past the last byte written, in the slot it will occupy once
+    //! everything before it has arrived, so out-of-order bytes are copied exactly once. Staged bytes are
+    //! not counted by buffer_size() and are overwritten by write(), so a stream fed through stage()
+    //! should not also be written directly.
+    //! \note In Storage::BufferChain mode the bytes are staged in a side buffer and copied into the chain
+    //! by commit().
+    //! \returns the number of bytes staged (bytes beyond remaining_capacity() are dropped)
+    size_t stage(const size_t offset, const std::string_view data);
+
+    //! Make the next `len` staged bytes readable, as if they had just been written
+    void commit(const size_t len);
+
     //! Signal that the byte stream has reached its ending
     void end_input();
 
     //! Indicate that the stream suffered an error.
-    void set_error() { _error = true; }
+    void set_error();
+    //!@}
+
+    //! \name Watermark callbacks
+    //! Each callback fires once per crossing of its threshold (edge-triggered), from inside the
+    //! write(), pop_output(), end_input() or set_error() call that crossed it. This lets an owner
+    //! arm and disarm its event sources on state changes instead of polling the stream.
+    //! Passing an empty std::function removes the callback.
+    //!@{
+
+    //! Call `callback` when the stream becomes readable: when buffer_size() rises to `high_watermark`
+    //! or more, or when the input ends or the stream errors.
+    void on_readable(std::function<void()> callback, const size_t high_watermark = 1);
+
+    //! Call `callback` when buffer_size() drains below `low_watermark`
+    void on_drained(std::function<void()> callback, const size_t low_watermark = 1);
+
+    //! Call `callback` when remaining_capacity() rises to `room` or more
+    void on_writable(std::function<void()> callback, const size_t room = 1);
     //!@}
 
     //! \name "Output" interface for the reader
@@ -56,6 +155,13 @@ class ByteStream {
     //! \returns a string
     std::string peek_output(const size_t len) const;
 
+    //! Peek at next "len" bytes of the stream without copying them
+    //! \returns up to two views into the stream's storage (the second is empty unless the bytes wrap around)
+    //! \note The views are invalidated by the next call to write() or pop_output().
+    //! \note In Storage::BufferChain mode the views cover at most the first two Buffers,
+    //! so they may hold fewer than `len` bytes even if more are available.
+    std::pair<std::string_view, std::string_view> peek_spans(const size_t len) const;
+
     //! Remove bytes from the buffer
     void pop_output(const size_t len);
 
@@ -63,6 +169,21 @@ class ByteStream {
     //! \returns a string
     std::string read(const size_t len);
 
+    //! Read (i.e., hand over and then pop) the next "len" bytes of the stream as Buffers
+    //! \note In Storage::BufferChain mode the returned Buffers share the written bytes; no copy is made.
+    //! \returns a BufferList
+    BufferList read_buffers(const size_t len);
+
+    //! Read (i.e., hand over and then pop) the next "len" bytes of the stream as one contiguous Buffer
+    //! \note In Storage::BufferChain mode, if the bytes lie within the first Buffer, the result is a slice
+    //! of it and no copy is made; otherwise (and in the other modes) the bytes are copied once.
+    //! \returns a Buffer
+    Buffer read_buffer(const size_t len);
+
+    //! Write up to `limit` bytes to `fd` directly from the stream's storage, and pop what was written
+    //! \returns the number of bytes written to `fd`
+    size_t read_into(FileDescriptor &fd, const size_t limit);
+
     //! \returns `true` if the stream input has ended
     bool input_ended() const;
 
@@ -79,6 +200,9 @@ class ByteStream {
     bool eof() const;
     //!@}
 
+    //! \returns how the stream holds its unread bytes
+    Storage storage() const { return _storage; }
+
     //! \name General accounting
     //!@{
 
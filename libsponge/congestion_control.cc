@@ -0,0 +1,228 @@
+#include "congestion_control.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+//! Initial window, in segments ([RFC 6928](\ref rfc::rfc6928))
+static constexpr uint64_t INITIAL_WINDOW_SEGMENTS = 10;
+
+//! \param[in] algorithm selects the algorithm
+//! \param[in] mss is the largest payload the sender puts in one segment
+unique_ptr<CongestionControl> CongestionControl::make(const Algorithm algorithm, const size_t mss) {
+    switch (algorithm) {
+        case Algorithm::None:
+            return nullptr;
+        case Algorithm::Reno:
+            return make_unique<RenoCongestionControl>(mss);
+        case Algorithm::Cubic:
+            return make_unique<CubicCongestionControl>(mss);
+        case Algorithm::BBR:
+            return make_unique<BBRCongestionControl>(mss);
+    }
+    throw invalid_argument("unknown congestion-control algorithm");
+}
+
+//! \param[in] name is the name of an algorithm, in lower case
+optional<CongestionControl::Algorithm> CongestionControl::algorithm_from_name(const string &name) {
+    if (name == "none") {
+        return Algorithm::None;
+    }
+    if (name == "reno") {
+        return Algorithm::Reno;
+    }
+    if (name == "cubic") {
+        return Algorithm::Cubic;
+    }
+    if (name == "bbr") {
+        return Algorithm::BBR;
+    }
+    return nullopt;
+}
+
+// Reno
+
+RenoCongestionControl::RenoCongestionControl(const size_t mss)
+    : _mss(mss), _cwnd(INITIAL_WINDOW_SEGMENTS * mss), _ssthresh(numeric_limits<uint64_t>::max()) {}
+
+void RenoCongestionControl::on_ack(const AckSample &sample) {
+    if (_cwnd < _ssthresh) {
+        // slow start, with appropriate byte counting limited to two segments per ACK (RFC 3465)
+        _cwnd += min(sample.bytes_acked, 2 * uint64_t{_mss});
+        return;
+    }
+
+    // congestion avoidance: one segment per window's worth of acknowledged bytes
+    _bytes_acked_in_avoidance += sample.bytes_acked;
+    if (_bytes_acked_in_avoidance >= _cwnd) {
+        _bytes_acked_in_avoidance -= _cwnd;
+        _cwnd += _mss;
+    }
+}
+
+void RenoCongestionControl::on_congestion_event(const uint64_t bytes_in_flight, const uint64_t /* now_ms */) {
+    _ssthresh = max(bytes_in_flight / 2, 2 * uint64_t{_mss});
+    _cwnd = _ssthresh;
+    _bytes_acked_in_avoidance = 0;
+}
+
+void RenoCongestionControl::on_retransmission_timeout(const uint64_t bytes_in_flight, const uint64_t /* now_ms */) {
+    _ssthresh = max(bytes_in_flight / 2, 2 * uint64_t{_mss});
+    _cwnd = _mss;
+    _bytes_acked_in_avoidance = 0;
+}
+
+// CUBIC
+
+CubicCongestionControl::CubicCongestionControl(const size_t mss)
+    : _mss(mss), _cwnd(static_cast<double>(INITIAL_WINDOW_SEGMENTS * mss)), _ssthresh(HUGE_VAL) {}
+
+void CubicCongestionControl::on_ack(const AckSample &sample) {
+    if (sample.rtt_ms.has_value()) {
+        _min_rtt_ms = min(_min_rtt_ms.value_or(*sample.rtt_ms), *sample.rtt_ms);
+    }
+
+    const double acked = static_cast<double>(sample.bytes_acked);
+    const double mss = static_cast<double>(_mss);
+    if (_cwnd < _ssthresh) {
+        _cwnd += min(acked, 2 * mss);
+        return;
+    }
+
+    if (not _epoch_start.has_value()) {
+        _epoch_start = sample.now_ms;
+        if (_cwnd < _w_max) {
+            _k = cbrt((_w_max - _cwnd) / mss / C);
+        } else {
+            _k = 0;
+            _w_max = _cwnd;
+        }
+        _w_est = _cwnd;
+    }
+
+    // where the cubic says the window should be one RTT from now
+    const double t = static_cast<double>(sample.now_ms - *_epoch_start + _min_rtt_ms.value_or(0)) / 1000.0;
+    double target = _w_max + C * pow(t - _k, 3) * mss;
+
+    // never grow slower than Reno would
+    _w_est += mss * (3 * (1 - BETA) / (1 + BETA)) * acked / _cwnd;
+    target = max(target, _w_est);
+
+    // grow towards the target over the next RTT, but by no more than half the window
+    target = min(target, 1.5 * _cwnd);
+    if (target > _cwnd) {
+        _cwnd += (target - _cwnd) * acked / _cwnd;
+    }
+}
+
+void CubicCongestionControl::reduce() {
+    // fast convergence: a flow whose window is shrinking releases bandwidth to newer flows sooner
+    _w_max = _cwnd < _w_max ? _cwnd * (1 + BETA) / 2 : _cwnd;
+    _ssthresh = max(_cwnd * BETA, 2.0 * static_cast<double>(_mss));
+    _epoch_start.reset();
+}
+
+void CubicCongestionControl::on_congestion_event(const uint64_t /* bytes_in_flight */, const uint64_t /* now_ms */) {
+    reduce();
+    _cwnd = _ssthresh;
+}
+
+void CubicCongestionControl::on_retransmission_timeout(const uint64_t /* bytes_in_flight */, const uint64_t /* now_ms */) {
+    reduce();
+    _cwnd = static_cast<double>(_mss);
+}
+
+// BBR
+
+BBRCongestionControl::BBRCongestionControl(const size_t mss) : _mss(mss), _cwnd(INITIAL_WINDOW_SEGMENTS * mss) {}
+
+uint64_t BBRCongestionControl::bdp() const {
+    if (not _min_rtt_ms.has_value() or _btl_bw == 0) {
+        return 0;
+    }
+    return _btl_bw * *_min_rtt_ms / 1000;
+}
+
+uint64_t BBRCongestionControl::pacing_rate() const { return static_cast<uint64_t>(_pacing_gain * _btl_bw); }
+
+void BBRCongestionControl::start_round(const AckSample &sample) {
+    // gains for the eight phases of a ProbeBW cycle: probe up, drain what the probe queued, then cruise
+    static constexpr array<double, 8> PROBE_BW_GAINS{1.25, 0.75, 1, 1, 1, 1, 1, 1};
+
+    _round++;
+    _round_start_ms = sample.now_ms;
+
+    switch (_mode) {
+        case Mode::Startup:
+            // the pipe is full once the delivery rate stops growing by 25% per round
+            if (_btl_bw >= _full_bw + _full_bw / 4) {
+                _full_bw = _btl_bw;
+                _full_bw_count = 0;
+            } else if (++_full_bw_count >= FULL_BW_ROUNDS) {
+                _mode = Mode::Drain;
+                _pacing_gain = 1 / HIGH_GAIN;
+            }
+            break;
+        case Mode::Drain:
+            if (sample.bytes_in_flight <= bdp()) {
+                _mode = Mode::ProbeBW;
+                _cycle_index = 0;
+                _pacing_gain = PROBE_BW_GAINS[0];
+                _cwnd_gain = 2;
+            }
+            break;
+        case Mode::ProbeBW:
+            _cycle_index = (_cycle_index + 1) % PROBE_BW_GAINS.size();
+            _pacing_gain = PROBE_BW_GAINS[_cycle_index];
+            break;
+    }
+}
+
+void BBRCongestionControl::on_ack(const AckSample &sample) {
+    _delivered += sample.bytes_acked;
+
+    if (sample.rtt_ms.has_value()) {
+        // the minimum RTT filter forgets samples older than its window, so route changes are noticed
+        if (not _min_rtt_ms.has_value() or *sample.rtt_ms <= *_min_rtt_ms or
+            sample.now_ms - _min_rtt_stamp_ms > MIN_RTT_WINDOW_MS) {
+            _min_rtt_ms = sample.rtt_ms;
+            _min_rtt_stamp_ms = sample.now_ms;
+        }
+    }
+
+    // delivery rate since the previous sample; the bandwidth filter keeps the max over the last few rounds
+    if (sample.now_ms > _sample_start_ms) {
+        const uint64_t rate =
+            (_delivered - _sample_start_delivered) * 1000 / (sample.now_ms - _sample_start_ms);
+        if (rate >= _btl_bw or _round - _btl_bw_round >= BW_WINDOW_ROUNDS) {
+            _btl_bw = rate;
+            _btl_bw_round = _round;
+        }
+        _sample_start_ms = sample.now_ms;
+        _sample_start_delivered = _delivered;
+    }
+
+    if (_min_rtt_ms.has_value() and sample.now_ms - _round_start_ms >= *_min_rtt_ms) {
+        start_round(sample);
+    }
+
+    // until the pipe is known to be full, grow like slow start; afterwards, converge on the model's window
+    const uint64_t target = max(static_cast<uint64_t>(_cwnd_gain * bdp()), 4 * uint64_t{_mss});
+    if (_mode != Mode::Startup) {
+        _cwnd = min(_cwnd + sample.bytes_acked, target);
+    } else if (bdp() == 0 or _cwnd < target) {
+        _cwnd += sample.bytes_acked;
+    }
+    _cwnd = max(_cwnd, 4 * uint64_t{_mss});
+}
+
+void BBRCongestionControl::on_congestion_event(const uint64_t bytes_in_flight, const uint64_t /* now_ms */) {
+    // the model, not loss, sets the window; just avoid sending more than is leaving the network
+    _cwnd = max(min(_cwnd, bytes_in_flight), 4 * uint64_t{_mss});
+}
+
+void BBRCongestionControl::on_retransmission_timeout(const uint64_t /* bytes_in_flight */, const uint64_t /* now_ms */) { _cwnd = _mss; }
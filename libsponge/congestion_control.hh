@@ -0,0 +1,187 @@
+#ifndef SPONGE_LIBSPONGE_CONGESTION_CONTROL_HH
+#define SPONGE_LIBSPONGE_CONGESTION_CONTROL_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+//! \brief A congestion-control algorithm, consulted by the TCPSender
+
+//! The sender reports acknowledgments and losses; the algorithm answers with a
+//! congestion window (how many bytes may be in flight) and, optionally, a pacing
+//! rate. Times are in milliseconds on the sender's clock, which advances with
+//! TCPSender::tick().
+class CongestionControl {
+  public:
+    //! The algorithms that make() can build
+    enum class Algorithm {
+        None,   //!< No congestion control: only the receiver's window limits the sender
+        Reno,   //!< Slow start and AIMD congestion avoidance ([RFC 5681](\ref rfc::rfc5681))
+        Cubic,  //!< CUBIC window growth ([RFC 9438](\ref rfc::rfc9438))
+        BBR     //!< A simplified model-based BBR: bottleneck bandwidth and min RTT set the window and rate
+    };
+
+    //! What the sender learned from one acknowledgment that advanced the cumulative ackno
+    struct AckSample {
+        uint64_t bytes_acked;              //!< newly acknowledged sequence numbers
+        uint64_t bytes_in_flight;          //!< sequence numbers still outstanding after the ACK
+        uint64_t now_ms;                   //!< the sender's clock
+        std::optional<uint64_t> rtt_ms{};  //!< a round-trip time measured from an unambiguous segment, if any
+    };
+
+    //! Construct the algorithm named by `algorithm`, for segments of up to `mss` bytes
+    //! \returns nullptr for Algorithm::None
+    static std::unique_ptr<CongestionControl> make(const Algorithm algorithm, const size_t mss);
+
+    //! \returns the algorithm named `name` ("none", "reno", "cubic" or "bbr"), if there is one
+    static std::optional<Algorithm> algorithm_from_name(const std::string &name);
+
+    //! \brief The cumulative ackno advanced
+    virtual void on_ack(const AckSample &sample) = 0;
+
+    //! \brief A loss was detected without a timeout (e.g. by duplicate ACKs)
+    //! \details Called once per loss episode, not once per lost segment.
+    virtual void on_congestion_event(const uint64_t bytes_in_flight, const uint64_t now_ms) = 0;
+
+    //! \brief The retransmission timer expired
+    virtual void on_retransmission_timeout(const uint64_t bytes_in_flight, const uint64_t now_ms) = 0;
+
+    //! \returns the congestion window, in bytes
+    virtual uint64_t cwnd() const = 0;
+
+    //! \returns the rate at which to release segments, in bytes per second (0 if the algorithm does not pace)
+    virtual uint64_t pacing_rate() const { return 0; }
+
+    //! \returns whether the window is still growing exponentially, so that a sender pacing at
+    //! cwnd / RTT needs a higher gain to keep up with it
+    virtual bool in_slow_start() const { return false; }
+
+    //! \returns a short name for the algorithm, e.g. for logging
+    virtual std::string name() const = 0;
+
+    virtual ~CongestionControl() = default;
+};
+
+//! \brief Reno: slow start, then one MSS of growth per round trip; halve on loss
+class RenoCongestionControl : public CongestionControl {
+  private:
+    size_t _mss;
+    uint64_t _cwnd;
+    uint64_t _ssthresh;
+    uint64_t _bytes_acked_in_avoidance{0};  //!< acknowledged bytes not yet credited to the window
+
+  public:
+    //! Start with an initial window of ten segments ([RFC 6928](\ref rfc::rfc6928))
+    explicit RenoCongestionControl(const size_t mss);
+
+    void on_ack(const AckSample &sample) override;
+    void on_congestion_event(const uint64_t bytes_in_flight, const uint64_t now_ms) override;
+    void on_retransmission_timeout(const uint64_t bytes_in_flight, const uint64_t now_ms) override;
+    uint64_t cwnd() const override { return _cwnd; }
+    bool in_slow_start() const override { return _cwnd < _ssthresh; }
+    std::string name() const override { return "reno"; }
+
+    //! \returns the slow-start threshold, in bytes
+    uint64_t ssthresh() const { return _ssthresh; }
+};
+
+//! \brief CUBIC: after a loss, the window follows a cubic function of the time since the loss,
+//! plateauing near the window where the loss happened
+class CubicCongestionControl : public CongestionControl {
+  private:
+    static constexpr double C = 0.4;     //!< cubic scaling constant, in segments per second cubed
+    static constexpr double BETA = 0.7;  //!< multiplicative decrease factor
+
+    size_t _mss;
+    double _cwnd;                            //!< in bytes; fractional so that slow growth is not rounded away
+    double _ssthresh;                        //!< in bytes
+    double _w_max{0};                        //!< window before the last reduction, in bytes
+    double _k{0};                            //!< seconds the cubic takes to climb back to `_w_max`
+    double _w_est{0};                        //!< window a Reno flow would have, in bytes
+    std::optional<uint64_t> _epoch_start{};  //!< when the current congestion-avoidance epoch began
+    std::optional<uint64_t> _min_rtt_ms{};
+
+    //! Remember the window at a loss and cut it by BETA, ending the current epoch
+    void reduce();
+
+  public:
+    //! Start with an initial window of ten segments
+    explicit CubicCongestionControl(const size_t mss);
+
+    void on_ack(const AckSample &sample) override;
+    void on_congestion_event(const uint64_t bytes_in_flight, const uint64_t now_ms) override;
+    void on_retransmission_timeout(const uint64_t bytes_in_flight, const uint64_t now_ms) override;
+    uint64_t cwnd() const override { return static_cast<uint64_t>(_cwnd); }
+    bool in_slow_start() const override { return _cwnd < _ssthresh; }
+    std::string name() const override { return "cubic"; }
+};
+
+//! \brief A simplified BBR: the window and pacing rate come from a model of the path
+//! (bottleneck bandwidth times minimum RTT), not from losses
+//! \details The model keeps a windowed maximum of the delivery rate and a windowed minimum of
+//! the RTT. The sender starts in Startup (doubling per round trip), drains the queue Startup
+//! built, then cycles its pacing gain around 1 to probe for more bandwidth. Compared with
+//! BBRv1 this omits ProbeRTT and per-packet rate samples: delivery rate is measured per ACK.
+class BBRCongestionControl : public CongestionControl {
+  private:
+    enum class Mode { Startup, Drain, ProbeBW };
+
+    static constexpr double HIGH_GAIN = 2.885;     //!< 2/ln(2): doubles the delivery rate each round
+    static constexpr unsigned FULL_BW_ROUNDS = 3;  //!< rounds without 25% growth that end Startup
+    static constexpr uint64_t MIN_RTT_WINDOW_MS = 10'000;
+    static constexpr unsigned BW_WINDOW_ROUNDS = 10;
+
+    size_t _mss;
+    uint64_t _cwnd;
+    Mode _mode{Mode::Startup};
+    double _pacing_gain{HIGH_GAIN};
+    double _cwnd_gain{HIGH_GAIN};
+
+    //! \name Bandwidth estimate
+    //!@{
+    uint64_t _delivered{0};               //!< total bytes acknowledged
+    uint64_t _sample_start_ms{0};         //!< start of the current delivery-rate sample
+    uint64_t _sample_start_delivered{0};  //!< `_delivered` at the start of the sample
+    uint64_t _btl_bw{0};                  //!< windowed-max delivery rate, in bytes per second
+    uint64_t _btl_bw_round{0};            //!< round in which `_btl_bw` was measured
+    //!@}
+
+    //! \name Minimum RTT estimate
+    //!@{
+    std::optional<uint64_t> _min_rtt_ms{};
+    uint64_t _min_rtt_stamp_ms{0};
+    //!@}
+
+    //! \name Round trips and Startup exit
+    //!@{
+    uint64_t _round{0};           //!< number of round trips so far
+    uint64_t _round_start_ms{0};  //!< when the current round began
+    uint64_t _full_bw{0};         //!< delivery rate at the last 25% increase
+    unsigned _full_bw_count{0};   //!< rounds since the last 25% increase
+    unsigned _cycle_index{0};     //!< position in the ProbeBW gain cycle
+    //!@}
+
+    //! \returns bottleneck bandwidth times min RTT, in bytes (0 until both are known)
+    uint64_t bdp() const;
+
+    //! Move to the next round trip, and make the per-round decisions
+    void start_round(const AckSample &sample);
+
+  public:
+    //! Start with an initial window of ten segments
+    explicit BBRCongestionControl(const size_t mss);
+
+    void on_ack(const AckSample &sample) override;
+    void on_congestion_event(const uint64_t bytes_in_flight, const uint64_t now_ms) override;
+    void on_retransmission_timeout(const uint64_t bytes_in_flight, const uint64_t now_ms) override;
+    uint64_t cwnd() const override { return _cwnd; }
+    uint64_t pacing_rate() const override;
+    std::string name() const override { return "bbr"; }
+
+    //! \returns the estimated bottleneck bandwidth, in bytes per second
+    uint64_t bottleneck_bandwidth() const { return _btl_bw; }
+};
+
+#endif  // SPONGE_LIBSPONGE_CONGESTION_CONTROL_HH
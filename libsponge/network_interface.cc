@@ -16,8 +16,11 @@ using namespace std;
 // 构造函数
 //! \param[in] ethernet_address Ethernet (what ARP calls "hardware") address of the interface
 //! \param[in] ip_address IP (what ARP calls "protocol") address of the interface
-NetworkInterface::NetworkInterface(const EthernetAddress &ethernet_address, const Address &ip_address)
-    : _ethernet_address(ethernet_address), _ip_address(ip_address) {
+//! \param[in] mtu is the largest IPv4 datagram the link carries
+NetworkInterface::NetworkInterface(const EthernetAddress &ethernet_address,
+                                   const Address &ip_address,
+                                   const size_t mtu)
+    : _ethernet_address(ethernet_address), _ip_address(ip_address), _mtu(mtu) {
     cerr << "DEBUG: Network interface has Ethernet address " << to_string(_ethernet_address) << " and IP address "
          << ip_address.ip() << "\n";
 }
@@ -72,6 +75,11 @@ EthernetFrame NetworkInterface::make_ipv4_frame(const InternetDatagram &dgram,
 //! \param[in] dgram the IPv4 datagram to be sent
 //! \param[in] next_hop the IP address of the interface to send it to
 void NetworkInterface::send_datagram(const InternetDatagram &dgram, const Address &next_hop) {
+    // 不支持分片：超过 MTU 的数据报直接丢弃
+    if (dgram.header().len > _mtu) {
+        return;
+    }
+
     const uint32_t next_hop_ip = next_hop.ipv4_numeric();
 
     // 1. 查 ARP 缓存表
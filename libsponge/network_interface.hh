@@ -45,6 +45,9 @@ class NetworkInterface {
     //! outbound queue of Ethernet frames that the NetworkInterface wants sent
     std::queue<EthernetFrame> _frames_out{};
 
+    //! largest IPv4 datagram the link carries in one frame
+    size_t _mtu;
+
     //! ARP 缓存表项的生存时间
     static constexpr size_t ARP_CACHE_LIFETIME_MS = 30000;
 
@@ -68,8 +71,15 @@ class NetworkInterface {
 
     EthernetFrame make_ipv4_frame(const InternetDatagram &dgram, const EthernetAddress &dst_mac) const;
   public:
+    static constexpr size_t DEFAULT_MTU = 1500;  //!< Ethernet's MTU (9000 or so for jumbo frames)
+
     //! \brief Construct a network interface with given Ethernet (network-access-layer) and IP (internet-layer) addresses
-    NetworkInterface(const EthernetAddress &ethernet_address, const Address &ip_address);
+    NetworkInterface(const EthernetAddress &ethernet_address,
+                     const Address &ip_address,
+                     const size_t mtu = DEFAULT_MTU);
+
+    //! \brief Largest IPv4 datagram the interface sends; there is no fragmentation, so larger ones are dropped
+    size_t mtu() const { return _mtu; }
 
     //! \brief Access queue of Ethernet frames awaiting transmission
     std::queue<EthernetFrame> &frames_out() { return _frames_out; }
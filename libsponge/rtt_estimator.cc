@@ -0,0 +1,40 @@
+#include "rtt_estimator.hh"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+RTTEstimator::RTTEstimator(const uint64_t initial_rto,
+                           const uint64_t min_rto,
+                           const uint64_t max_rto,
+                           const uint64_t granularity)
+    : _initial_rto(initial_rto), _min_rto(min_rto), _max_rto(max_rto), _granularity(granularity) {}
+
+//! \param[in] rtt is a round-trip time measured on a segment that was sent only once, or echoed in a timestamp
+//! \param[in] expected_samples is the number of samples expected in one RTT (RFC 7323 appendix G)
+void RTTEstimator::sample(const uint64_t rtt, const uint64_t expected_samples) {
+    const double r = static_cast<double>(rtt);
+    if (not _srtt.has_value()) {
+        // first measurement (RFC 6298 section 2.2)
+        _srtt = r;
+        _rttvar = r / 2;
+    } else {
+        // subsequent measurements (section 2.3): RTTVAR is updated with the old SRTT
+        const double n = static_cast<double>(max<uint64_t>(expected_samples, 1));
+        const double alpha = 0.125 / n;
+        const double beta = 0.25 / n;
+        _rttvar = (1 - beta) * _rttvar + beta * abs(*_srtt - r);
+        _srtt = (1 - alpha) * *_srtt + alpha * r;
+    }
+    _latest_rtt = rtt;
+    _min_rtt = min(_min_rtt.value_or(rtt), rtt);
+}
+
+uint64_t RTTEstimator::rto() const {
+    if (not _srtt.has_value()) {
+        return _initial_rto;
+    }
+    const double rto = *_srtt + max(static_cast<double>(_granularity), 4 * _rttvar);
+    return clamp(static_cast<uint64_t>(ceil(rto)), _min_rto, _max_rto);
+}
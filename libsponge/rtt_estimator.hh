@@ -0,0 +1,56 @@
+#ifndef SPONGE_LIBSPONGE_RTT_ESTIMATOR_HH
+#define SPONGE_LIBSPONGE_RTT_ESTIMATOR_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+
+//! \brief Smoothed round-trip time and retransmission timeout, as in [RFC 6298](\ref rfc::rfc6298)
+
+//! The caller feeds in samples taken only from segments that were not retransmitted
+//! (Karn's algorithm), or from timestamp echoes, which are unambiguous even for retransmissions;
+//! the estimator keeps SRTT and RTTVAR and derives the RTO from them.
+//! All times are in milliseconds.
+class RTTEstimator {
+  private:
+    uint64_t _initial_rto;  //!< RTO before the first sample
+    uint64_t _min_rto;      //!< lower clamp on the computed RTO
+    uint64_t _max_rto;      //!< upper clamp on the computed RTO
+    uint64_t _granularity;  //!< clock granularity G
+
+    std::optional<double> _srtt{};  //!< smoothed RTT
+    double _rttvar{0};              //!< RTT variation
+    std::optional<uint64_t> _latest_rtt{};
+    std::optional<uint64_t> _min_rtt{};
+
+  public:
+    //! \param initial_rto is the RTO to use until the first sample arrives
+    //! \param min_rto and \p max_rto bound the computed RTO
+    //! \param granularity is the resolution of the clock that timed the samples
+    RTTEstimator(const uint64_t initial_rto,
+                 const uint64_t min_rto,
+                 const uint64_t max_rto,
+                 const uint64_t granularity = 1);
+
+    //! Update the estimate with a new round-trip time sample
+    //! \param expected_samples is how many samples to expect per RTT; with per-ACK samples (from
+    //! [timestamps](\ref rfc::rfc7323)) the gains are divided by it, so that SRTT still has a memory of a few RTTs
+    void sample(const uint64_t rtt, const uint64_t expected_samples = 1);
+
+    //! \returns the retransmission timeout: SRTT + max(G, 4 * RTTVAR), clamped to [min_rto, max_rto]
+    uint64_t rto() const;
+
+    //! \returns `rto` doubled after a timeout, without exceeding the upper clamp
+    uint64_t backed_off(const uint64_t rto) const { return std::max(std::min(2 * rto, _max_rto), rto); }
+
+    //! \name Accessors
+    //!@{
+    bool has_sample() const { return _srtt.has_value(); }                //!< whether any sample arrived
+    std::optional<double> srtt() const { return _srtt; }                 //!< smoothed RTT
+    double rttvar() const { return _rttvar; }                            //!< RTT variation
+    std::optional<uint64_t> latest_rtt() const { return _latest_rtt; }  //!< most recent sample
+    std::optional<uint64_t> min_rtt() const { return _min_rtt; }        //!< smallest sample so far
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_RTT_ESTIMATOR_HH
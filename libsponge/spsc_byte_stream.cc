@@ -0,0 +1,117 @@
+#include "spsc_byte_stream.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+//! \param[in] capacity the maximum number of unread bytes the stream will hold
+SPSCByteStream::SPSCByteStream(const size_t capacity) : _buffer(capacity), _capacity(capacity) {}
+
+//! \param[in] ready returns `true` once the caller's condition holds
+//! \param[in] deadline the time after which to give up
+template <typename ReadyT>
+bool SPSCByteStream::wait_until(const ReadyT &ready, const Clock::time_point deadline) {
+    // a short busy-spin catches the common case where the other thread is mid-copy,
+    // after which we yield the CPU between checks
+    constexpr unsigned SPIN_ITERATIONS = 1024;
+    for (unsigned i = 0; i < SPIN_ITERATIONS; i++) {
+        if (ready()) {
+            return true;
+        }
+    }
+
+    while (not ready()) {
+        if (Clock::now() >= deadline) {
+            return false;
+        }
+        this_thread::yield();
+    }
+    return true;
+}
+
+size_t SPSCByteStream::write(const string &data) {
+    if (input_ended() or error()) {
+        return 0;
+    }
+
+    const size_t tail = _bytes_written.load(memory_order_relaxed);
+    const size_t len_to_write = min(data.size(), remaining_capacity());
+    if (len_to_write == 0) {
+        return 0;
+    }
+
+    // copy in at most two pieces, then publish the new bytes to the consumer
+    const size_t offset = tail % _capacity;
+    const size_t first_len = min(len_to_write, _capacity - offset);
+    memcpy(_buffer.data() + offset, data.data(), first_len);
+    memcpy(_buffer.data(), data.data() + first_len, len_to_write - first_len);
+
+    _bytes_written.store(tail + len_to_write, memory_order_release);
+    return len_to_write;
+}
+
+size_t SPSCByteStream::remaining_capacity() const { return _capacity - buffer_size(); }
+
+//! \param[in] len the number of free bytes to wait for
+//! \param[in] deadline the time after which to give up
+bool SPSCByteStream::wait_writable(const size_t len, const Clock::time_point deadline) const {
+    return wait_until([&] { return error() or remaining_capacity() >= min(len, _capacity); }, deadline);
+}
+
+//! \param[in] len bytes will be copied from the output side of the buffer
+string SPSCByteStream::peek_output(const size_t len) const {
+    const auto [first, second] = peek_spans(len);
+    string result;
+    result.reserve(first.size() + second.size());
+    result.append(first).append(second);
+    return result;
+}
+
+//! \param[in] len bytes will be exposed from the output side of the buffer
+pair<string_view, string_view> SPSCByteStream::peek_spans(const size_t len) const {
+    const size_t head = _bytes_read.load(memory_order_relaxed);
+    const size_t len_to_peek = min(len, _bytes_written.load(memory_order_acquire) - head);
+    if (len_to_peek == 0) {
+        return {};
+    }
+
+    const size_t offset = head % _capacity;
+    const size_t first_len = min(len_to_peek, _capacity - offset);
+    return {{_buffer.data() + offset, first_len}, {_buffer.data(), len_to_peek - first_len}};
+}
+
+//! \param[in] len bytes will be removed from the output side of the buffer
+void SPSCByteStream::pop_output(const size_t len) {
+    if (len > buffer_size()) {
+        throw invalid_argument("SPSCByteStream::pop_output(): len is greater than buffer size");
+    }
+    // release: the producer may reuse the space only after we are done reading it
+    _bytes_read.store(_bytes_read.load(memory_order_relaxed) + len, memory_order_release);
+}
+
+//! \param[in] len bytes will be popped and returned
+//! \returns a string
+string SPSCByteStream::read(const size_t len) {
+    const string result = peek_output(len);
+    pop_output(result.size());
+    return result;
+}
+
+//! \param[in] deadline the time after which to give up
+bool SPSCByteStream::wait_readable(const Clock::time_point deadline) const {
+    return wait_until([&] { return not buffer_empty() or input_ended() or error(); }, deadline);
+}
+
+size_t SPSCByteStream::buffer_size() const {
+    // load the read position first: it only grows, so the difference can never underflow
+    const size_t head = _bytes_read.load(memory_order_acquire);
+    return _bytes_written.load(memory_order_acquire) - head;
+}
+
+bool SPSCByteStream::eof() const {
+    // input_ended is set after the last write, so once it is visible all bytes_written are too
+    return input_ended() and buffer_empty();
+}
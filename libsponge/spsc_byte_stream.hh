@@ -0,0 +1,123 @@
+#ifndef SPONGE_LIBSPONGE_SPSC_BYTE_STREAM_HH
+#define SPONGE_LIBSPONGE_SPSC_BYTE_STREAM_HH
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//! \brief An in-order byte stream that one thread writes and another thread reads.
+
+//! Has the same interface and capacity accounting as ByteStream, but the
+//! read and write positions are atomics, so a single producer thread and a
+//! single consumer thread can use it concurrently without a lock (and
+//! without moving the bytes through the kernel, as a socketpair would).
+//!
+//! Only the producer may call the "input" methods and only the consumer
+//! may call the "output" methods; the accessors may be called from either.
+class SPSCByteStream {
+  public:
+    using Clock = std::chrono::steady_clock;  //!< Clock used by the wait helpers
+
+  private:
+    std::vector<char> _buffer;  //!< Ring storage; byte `n` of the stream lives at `_buffer[n % _capacity]`
+    size_t _capacity;
+
+    std::atomic<size_t> _bytes_written{0};  //!< Total bytes written; only the producer stores to it
+    std::atomic<size_t> _bytes_read{0};     //!< Total bytes popped; only the consumer stores to it
+    std::atomic<bool> _input_ended{false};
+    std::atomic<bool> _error{false};
+
+    //! Spin, then yield, until `ready()` returns true or `deadline` passes
+    template <typename ReadyT>
+    static bool wait_until(const ReadyT &ready, const Clock::time_point deadline);
+
+  public:
+    //! Construct a stream with room for `capacity` bytes.
+    explicit SPSCByteStream(const size_t capacity);
+
+    //! \name "Input" interface for the writer (producer thread only)
+    //!@{
+
+    //! Write a string of bytes into the stream. Write as many
+    //! as will fit, and return how many were written.
+    //! \returns the number of bytes accepted into the stream
+    size_t write(const std::string &data);
+
+    //! \returns the number of additional bytes that the stream has space for
+    size_t remaining_capacity() const;
+
+    //! Signal that the byte stream has reached its ending
+    void end_input() { _input_ended.store(true, std::memory_order_release); }
+
+    //! Indicate that the stream suffered an error.
+    void set_error() { _error.store(true, std::memory_order_release); }
+
+    //! Wait until at least `len` bytes of space are free (or the stream has errored)
+    //! \returns `true` if the space is available, `false` if `deadline` passed first
+    bool wait_writable(const size_t len = 1, const Clock::time_point deadline = Clock::time_point::max()) const;
+    //!@}
+
+    //! \name "Output" interface for the reader (consumer thread only)
+    //!@{
+
+    //! Peek at next "len" bytes of the stream
+    //! \returns a string
+    std::string peek_output(const size_t len) const;
+
+    //! Peek at next "len" bytes of the stream without copying them
+    //! \returns up to two views into the stream's storage (the second is empty unless the bytes wrap around)
+    std::pair<std::string_view, std::string_view> peek_spans(const size_t len) const;
+
+    //! Remove bytes from the buffer
+    void pop_output(const size_t len);
+
+    //! Read (i.e., copy and then pop) the next "len" bytes of the stream
+    //! \returns a string
+    std::string read(const size_t len);
+
+    //! Wait until there is something to read, or the stream has ended or errored
+    //! \returns `true` if the stream is readable, `false` if `deadline` passed first
+    bool wait_readable(const Clock::time_point deadline = Clock::time_point::max()) const;
+    //!@}
+
+    //! \name Accessors (either thread)
+    //!@{
+
+    //! \returns `true` if the stream input has ended
+    bool input_ended() const { return _input_ended.load(std::memory_order_acquire); }
+
+    //! \returns `true` if the stream has suffered an error
+    bool error() const { return _error.load(std::memory_order_acquire); }
+
+    //! \returns the maximum amount that can currently be read from the stream
+    size_t buffer_size() const;
+
+    //! \returns `true` if the buffer is empty
+    bool buffer_empty() const { return buffer_size() == 0; }
+
+    //! \returns `true` if the output has reached the ending
+    bool eof() const;
+
+    //! Total number of bytes written
+    size_t bytes_written() const { return _bytes_written.load(std::memory_order_acquire); }
+
+    //! Total number of bytes popped
+    size_t bytes_read() const { return _bytes_read.load(std::memory_order_acquire); }
+    //!@}
+
+    //! \name
+    //! An SPSCByteStream is shared between two threads, so it cannot be copied or moved
+    //!@{
+    SPSCByteStream(const SPSCByteStream &other) = delete;
+    SPSCByteStream &operator=(const SPSCByteStream &other) = delete;
+    SPSCByteStream(SPSCByteStream &&other) = delete;
+    SPSCByteStream &operator=(SPSCByteStream &&other) = delete;
+    ~SPSCByteStream() = default;
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_SPSC_BYTE_STREAM_HH
@@ -1,22 +1,36 @@
 #ifndef SPONGE_LIBSPONGE_STREAM_REASSEMBLER_HH
 #define SPONGE_LIBSPONGE_STREAM_REASSEMBLER_HH
 
+#include "buffer.hh"
 #include "byte_stream.hh"
+#include "interval_set.hh"
 
 #include <cstdint>
 #include <string>
-#include <map>
+#include <string_view>
+#include <vector>
 
 //! \brief A class that assembles a series of excerpts from a byte stream (possibly out of order,
 //! possibly overlapping) into an in-order byte stream.
 class StreamReassembler {
   private:
     // Your code here -- add private members as necessary.
-    std::map<size_t, std::string> _unassemble_strs;
-    size_t _next_assembled_idx;
-    size_t _unassembled_bytes_num;
+    //! Indices of the bytes that have been staged in `_output` but not yet assembled.
+    //! Out-of-order bytes are copied straight into their final slot in the output stream's
+    //! free space (see ByteStream::stage), so this is the only per-substring bookkeeping.
+    IntervalSet _staged{};
     size_t _eof_idx;
 
+    //! Start indices of the most recently staged substrings, newest first (at most MAX_RECENT_RANGES)
+    std::vector<uint64_t> _recent_arrivals{};
+
+    uint64_t _fast_path_pushes{};  //!< substrings that arrived in order with nothing staged
+    uint64_t _slow_path_pushes{};  //!< substrings that had to be staged or merged
+    uint64_t _duplicate_pushes{};  //!< substrings whose bytes had all been assembled already
+
+    //! Note an eof flag on a substring ending at `end`, and end the output once everything before it is assembled
+    void finish_push(const uint64_t end, const bool eof, const uint64_t window_end);
+
     ByteStream _output;  //!< The reassembled in-order byte stream
     size_t _capacity;    //!< The maximum number of bytes
 
@@ -24,7 +38,8 @@ class StreamReassembler {
     //! \brief Construct a `StreamReassembler` that will store up to `capacity` bytes.
     //! \note This capacity limits both the bytes that have been reassembled,
     //! and those that have not yet been reassembled.
-    StreamReassembler(const size_t capacity);
+    //! \param storage how the reassembled byte stream holds its bytes
+    StreamReassembler(const size_t capacity, const ByteStream::Storage storage = ByteStream::Storage::Ring);
 
     //! \brief Receive a substring and write any newly contiguous bytes into the stream.
     //!
@@ -36,6 +51,16 @@ class StreamReassembler {
     //! \param eof the last byte of `data` will be the last byte in the entire stream
     void push_substring(const std::string &data, const uint64_t index, const bool eof);
 
+    //! \brief Receive a substring (as a view) and write any newly contiguous bytes into the stream.
+    //! \details Same as above; the bytes are copied once, into their place in the output stream.
+    void push_substring(const std::string_view data, const uint64_t index, const bool eof);
+
+    //! \brief Receive a substring held in a Buffer (e.g. a segment's payload).
+    //! \details In Storage::BufferChain mode, in-order data with nothing staged behind it is
+    //! appended by sharing `data`'s storage, with no copy at all; otherwise the bytes are copied
+    //! once, straight into their place in the output stream.
+    void push_substring(const Buffer &data, const uint64_t index, const bool eof);
+
     //! \name Access the reassembled byte stream
     //!@{
     const ByteStream &stream_out() const { return _output; }
@@ -51,6 +76,33 @@ class StreamReassembler {
     //! \brief Is the internal state empty (other than the output stream)?
     //! \returns `true` if no substrings are waiting to be assembled
     bool empty() const;
+
+    //! \returns the stream index of the next byte expected, i.e. the first one not yet assembled
+    uint64_t first_unassembled() const { return _output.bytes_written(); }
+
+    //! \brief Change the number of bytes the reassembler will store (assembled and not)
+    //! \throws std::invalid_argument if the new capacity cannot hold the assembled bytes and every
+    //! substring still waiting to be assembled
+    void set_capacity(const size_t capacity);
+
+    //! \name Counters of how substrings were handled
+    //!@{
+    uint64_t fast_path_pushes() const { return _fast_path_pushes; }  //!< in order, written straight through
+    uint64_t slow_path_pushes() const { return _slow_path_pushes; }  //!< out of order, staged in the window
+    uint64_t duplicate_pushes() const { return _duplicate_pushes; }  //!< nothing new, dropped
+    //!@}
+
+    //! \returns the ranges of stream indices that have arrived but not yet been assembled, in order
+    const std::vector<IntervalSet::Interval> &unassembled_ranges() const { return _staged.intervals(); }
+
+    //! How many recently staged substrings recent_unassembled_ranges() remembers
+    static constexpr size_t MAX_RECENT_RANGES = 4;
+
+    //! \brief Up to `max_ranges` unassembled ranges, most recently changed first
+    //! \details This is the order [SACK](\ref rfc::rfc2018) wants: the range holding the newest
+    //! substring comes first, then the ranges of earlier arrivals, so that a sender that misses
+    //! an ACK still learns about every hole from the next few.
+    std::vector<IntervalSet::Interval> recent_unassembled_ranges(const size_t max_ranges) const;
 };
 
 #endif  // SPONGE_LIBSPONGE_STREAM_REASSEMBLER_HH
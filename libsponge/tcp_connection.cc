@@ -1,5 +1,8 @@
 #include "tcp_connection.hh"
 
+#include "file_descriptor.hh"
+
+#include <cmath>
 #include <iostream>
 
 // Dummy implementation of a TCP connection
@@ -12,10 +15,23 @@ void DUMMY_CODE(Targs &&... /* unused */) {}
 
 using namespace std;
 
+// 能让 capacity 放进 16 位窗口字段的最小移位数 (RFC 7323 规定不超过 14)
+static uint8_t window_shift_for(const size_t capacity) {
+    uint8_t shift = 0;
+    while (shift < TCPHeader::MAX_WINDOW_SCALE && (capacity >> shift) > UINT16_MAX) {
+        shift++;
+    }
+    return shift;
+}
+
 // Helper function: 检查 _sender 的输出队列，为其中的每个数据段填充 ACK 和窗口信息，并将其移至 _segments_out 队列。
 void TCPConnection::send_segments_from_sender() {
     // 2. 在发送当前数据包之前，TCPConnection 会获取当前它自己的 TCPReceiver 的 ackno 和 window size，
     //    将其放置到待发送 TCPSegment 中（设置window_size和ackno），并设置其 ACK 标志。
+    // 通告窗口之前，先按已经通告过的右边界允许的程度缩小接收缓冲区
+    if (!_sender.segments_out().empty()) {
+        shrink_receive_buffer();
+    }
     while (!_sender.segments_out().empty()) {
         TCPSegment seg = _sender.segments_out().front();
         _sender.segments_out().pop();
@@ -24,8 +40,47 @@ void TCPConnection::send_segments_from_sender() {
         if (_receiver.ackno().has_value()) {
             seg.header().ack = true;
             seg.header().ackno = _receiver.ackno().value();
-            // 窗口大小不能超过 2^16 - 1
-            seg.header().win = min(static_cast<size_t>(UINT16_MAX), _receiver.window_size());
+            // 窗口大小不能超过 2^16 - 1；协商了窗口扩大选项时按移位数缩小 (SYN 中的窗口从不缩放)
+            const size_t window = seg.header().syn ? _receiver.window_size()
+                                                   : _receiver.window_size() >> _rcv_window_shift;
+            seg.header().win = min(static_cast<size_t>(UINT16_MAX), window);
+            _last_ack_sent = seg.header().ackno;
+            // 记录通告过的最远的右边界：窗口按移位数截断，边界看起来可能左移最多 2^shift - 1 字节，
+            // 但对端仍可以按之前的边界发送
+            const uint32_t advertised =
+                seg.header().syn ? seg.header().win : uint32_t{seg.header().win} << _rcv_window_shift;
+            const WrappingInt32 edge = seg.header().ackno + advertised;
+            if (!_last_window_edge.has_value() || edge - _last_window_edge.value() > 0) {
+                _last_window_edge = edge;
+            }
+            // 这个段带上了 ACK，推迟的 ACK 不用再单独发送
+            _ack_delayed_ms.reset();
+            _unacked_bytes = 0;
+        }
+
+        // SACK 协商：在 SYN 中声明支持；双方都支持后，在每个段上报告乱序到达的数据
+        // SYN 中同时通告我方能接收的 MSS
+        if (seg.header().syn) {
+            seg.header().mss = _cfg.mss;
+            seg.header().sack_permitted = _cfg.sack;
+            // 主动打开时总是提出窗口扩大；被动打开时只有对端提出了才回应
+            if (_cfg.window_scaling && (!_receiver.ackno().has_value() || _window_scaling_enabled)) {
+                seg.header().window_scale = window_shift_for(max_recv_capacity());
+            }
+        }
+        // 时间戳：主动打开的 SYN 提出 (此时没有可回显的值)；双方都支持后每个段都带上
+        if (_timestamps_enabled || (seg.header().syn && _cfg.timestamps && !_receiver.ackno().has_value())) {
+            seg.header().timestamps = TCPHeader::Timestamps{_sender.timestamp(), _ts_recent};
+        }
+        if (_sack_enabled) {
+            // 选项不能让段超出 MSS 的大小 (否则可能超过 MTU)：时间戳选项的字节已经从发送方的最大负载中扣除，
+            // SACK 选项有 4 字节开销，每块 8 字节
+            const size_t room = _sender.mss() - min(_sender.mss(), seg.payload().size());
+            const size_t max_blocks = seg.header().timestamps.has_value() ? TCPHeader::MAX_SACK_BLOCKS_WITH_TIMESTAMPS
+                                                                          : TCPHeader::MAX_SACK_BLOCKS;
+            if (room >= 12) {
+                seg.header().sack_blocks = _receiver.sack_blocks(min(max_blocks, (room - 4) / 8));
+            }
         }
 
         _segments_out.push(seg);
@@ -70,15 +125,135 @@ void TCPConnection::send_rst_and_die() {
     }
 }
 
+// Helper function: 时间戳检查。返回 false 表示这个段被 PAWS (RFC 7323) 判定为旧的重复段，应当丢弃
+bool TCPConnection::check_timestamps(const TCPSegment &seg) {
+    if (!_timestamps_enabled || !seg.header().timestamps.has_value() || seg.header().syn) {
+        return true;
+    }
+    const uint32_t tsval = seg.header().timestamps.value().val;
+    // 时间戳按差值的符号比较先后：序号回绕之后到达的旧段，时间戳一定比 TS.Recent 旧
+    if (static_cast<int32_t>(tsval - _ts_recent) < 0) {
+        return false;
+    }
+    // 只用不超过上次 ackno 的段更新 TS.Recent，这样回显的是推进了 ackno 的那个段的时间戳，
+    // 对端据此得到的 RTT 样本包含了我方推迟确认的时间
+    if (!_last_ack_sent.has_value() || seg.header().seqno - _last_ack_sent.value() <= 0) {
+        _ts_recent = tsval;
+    }
+    return true;
+}
+
+// Helper function: 发送一个纯 ACK
+void TCPConnection::send_ack() {
+    _sender.send_empty_segment();
+    send_segments_from_sender();
+}
+
+void TCPConnection::check_window_update() {
+    if (!_is_active || !_receiver.ackno().has_value() || !_last_window_edge.has_value() ||
+        _receiver.stream_out().input_ended()) {
+        return;
+    }
+    // 现在能通告的窗口右边界 (窗口字段按移位数截断)
+    const size_t window = min(static_cast<size_t>(UINT16_MAX), _receiver.window_size() >> _rcv_window_shift);
+    const WrappingInt32 edge = _receiver.ackno().value() + static_cast<uint32_t>(window << _rcv_window_shift);
+    // 避免糊涂窗口综合征 (RFC 1122 4.2.3.3)：右边界至少前进 min(MSS, 接收缓冲区的一半) 才通告
+    const int64_t threshold = min<int64_t>(_cfg.mss, _receiver.capacity() / 2);
+    if (edge - _last_window_edge.value() >= max<int64_t>(threshold, 1)) {
+        send_ack();
+    }
+}
+
+// Helper function: 接收缓冲区可能达到的最大容量，窗口扩大的移位数按它选择
+size_t TCPConnection::max_recv_capacity() const {
+    return _cfg.autotune_buffers ? max(_cfg.recv_capacity, _cfg.max_recv_capacity) : _cfg.recv_capacity;
+}
+
+// Helper function: 缓冲区自动调整。每个 RTT 按应用读取的速度和发送窗口放大缓冲区，空闲之后恢复初始大小
+void TCPConnection::autotune_buffers(const size_t ms_since_last_tick) {
+    if (!_cfg.autotune_buffers) {
+        return;
+    }
+    ByteStream &inbound = _receiver.stream_out();
+    ByteStream &outbound = _sender.stream_in();
+
+    // 空闲：两个方向都没有缓存或在途的数据，并且一个 rt_timeout 内没有收到段。此时缩小缓冲区不会丢掉数据
+    if (buffers_drained() && _time_since_last_segment_received_ms >= _cfg.rt_timeout) {
+        if (_receiver.capacity() > _cfg.recv_capacity) {
+            _recv_capacity_target = _cfg.recv_capacity;
+        }
+        shrink_receive_buffer();
+        outbound.set_capacity(min(outbound.capacity(), _cfg.send_capacity));
+        _autotune_round_ms = 0;
+        _autotune_bytes_read = inbound.bytes_read();
+        return;
+    }
+
+    const optional<double> srtt = _sender.rtt_estimator().srtt();
+    _autotune_round_ms += ms_since_last_tick;
+    if (!srtt.has_value() || static_cast<double>(_autotune_round_ms) < max(srtt.value(), 1.0)) {
+        return;
+    }
+
+    // 接收缓冲区放大到这个 RTT 内应用读走字节数的两倍：对端可能还在加速 (慢启动每个 RTT 翻倍)。
+    // 应用读得慢时读走的字节少，缓冲区不会增长。窗口字段装不下的部分没有意义
+    const uint64_t read = inbound.bytes_read() - _autotune_bytes_read;
+    const size_t recv_limit = min(max_recv_capacity(), size_t{UINT16_MAX} << _rcv_window_shift);
+    const size_t recv_target = min<uint64_t>(2 * read, recv_limit);
+    if (recv_target > _receiver.capacity()) {
+        _receiver.set_capacity(recv_target);
+        _recv_capacity_target.reset();
+    }
+
+    // 发送缓冲区放大到发送窗口的两倍，让应用写入的数据足够填满窗口
+    const size_t send_limit = max(_cfg.send_capacity, _cfg.max_send_capacity);
+    const size_t send_target = min<uint64_t>(2 * _sender.send_window(), send_limit);
+    if (send_target > outbound.capacity()) {
+        outbound.set_capacity(send_target);
+    }
+
+    _autotune_round_ms = 0;
+    _autotune_bytes_read = inbound.bytes_read();
+}
+
+// Helper function: 两个方向都没有缓存或在途的数据
+bool TCPConnection::buffers_drained() const {
+    return _receiver.stream_out().buffer_empty() && _receiver.unassembled_bytes() == 0 &&
+           _sender.stream_in().buffer_empty() && _sender.bytes_in_flight() == 0;
+}
+
+// Helper function: 把接收缓冲区缩小到 _recv_capacity_target，但不收回已经通告给对端的窗口
+// (RFC 1122 4.2.2.16, RFC 7323 2.4)：容量至少要装下已缓存的字节，以及 ackno 到上次通告的右边界之间的字节。
+// 对端用掉这段窗口、应用读走数据之后，下次通告窗口之前再继续缩小
+void TCPConnection::shrink_receive_buffer() {
+    if (!_recv_capacity_target.has_value() || !_receiver.ackno().has_value()) {
+        return;
+    }
+    const int32_t offered = _last_window_edge.has_value() ? _last_window_edge.value() - _receiver.ackno().value() : 0;
+    const size_t floor = _receiver.stream_out().buffer_size() + static_cast<size_t>(max(offered, 0));
+    const size_t capacity = max(_recv_capacity_target.value(), floor);
+    if (capacity < _receiver.capacity()) {
+        _receiver.set_capacity(capacity);
+    }
+    if (_receiver.capacity() <= _recv_capacity_target.value()) {
+        _recv_capacity_target.reset();
+    }
+}
+
+// Helper function: 两个方向的流是否都已结束：入站流已经收到 FIN，出站流的数据和 FIN 都已发出并被确认。
+// 出站流结束输入时缓冲区里可能还有数据没有发出 (例如在等待窗口或者 pacing 的令牌)，这时在途字节数也可能为 0
+bool TCPConnection::streams_finished() const {
+    return _receiver.stream_out().input_ended() && _sender.stream_in().eof() &&
+           _sender.next_seqno_absolute() == _sender.stream_in().bytes_written() + 2 && _sender.bytes_in_flight() == 0;
+}
+
 // Helper function: 检查是否满足优雅关闭的条件
 void TCPConnection::check_for_shutdown() {
     // 优雅关闭条件:
     // 1. 入站流已经全部接收完毕。
     // 2. 出站流已经全部发送完毕。
     // 3. 需要发送的数据对方已完全确认。
-    if (_receiver.stream_out().input_ended() && 
-        _sender.stream_in().input_ended() && 
-        _sender.bytes_in_flight() == 0) {
+    if (streams_finished()) {
         
         // 如果 _linger_after_streams_finish 为 false，立即结束连接。 (对应 TIME_WAIT 的特殊情况)
         if (!_linger_after_streams_finish) {
@@ -111,10 +286,46 @@ void TCPConnection::segment_received(const TCPSegment &seg) {
         return;
     }
     
+    // PAWS：丢弃旧的重复段，但仍回复一个 ACK
+    if (!check_timestamps(seg)) {
+        if (seg.length_in_sequence_space() > 0) {
+            send_ack();
+        }
+        return;
+    }
+
     // 复制段以进行状态检查 (在调用 _receiver 之前)
     TCPSegment original_seg = seg;
 
+    // 对端的 SYN 中带有 SACK-permitted，且我方也开启了 SACK
+    if (seg.header().syn && seg.header().sack_permitted && _cfg.sack) {
+        _sack_enabled = true;
+    }
+
+    // 对端第一个 SYN 中的 MSS 选项限制我方发送的段大小
+    if (seg.header().syn && seg.header().mss.has_value() && !_receiver.ackno().has_value()) {
+        _sender.set_peer_mss(seg.header().mss.value());
+    }
+
+    // 双方的 SYN 中都带有窗口扩大选项时才启用 (RFC 7323)
+    if (seg.header().syn && seg.header().window_scale.has_value() && _cfg.window_scaling &&
+        !_receiver.ackno().has_value()) {
+        _window_scaling_enabled = true;
+        _snd_window_shift = min(seg.header().window_scale.value(), TCPHeader::MAX_WINDOW_SCALE);
+        _rcv_window_shift = window_shift_for(max_recv_capacity());
+    }
+
+    // 双方的 SYN 中都带有时间戳选项时才启用，此后回显对端的 TSval
+    if (seg.header().syn && seg.header().timestamps.has_value() && _cfg.timestamps &&
+        !_receiver.ackno().has_value()) {
+        _timestamps_enabled = true;
+        _ts_recent = seg.header().timestamps.value().val;
+        _sender.set_option_overhead(TCPHeader::TIMESTAMPS_LENGTH);
+    }
+
     // 2. 把这个段交给TCPReceiver
+    const optional<WrappingInt32> ackno_before = _receiver.ackno();
+    const size_t unassembled_before = _receiver.unassembled_bytes();
     _receiver.segment_received(seg);
 
     // 3. 如果设置了ACK标志，则告诉TCPSender它关心的传入段的字段：ackno和window_size。
@@ -124,7 +335,19 @@ void TCPConnection::segment_received(const TCPSegment &seg) {
         // - 已收到对端SYN：_receiver.ackno().has_value()
         // 在LISTEN状态，两者都为 false，因此纯 ACK 会被忽略，sender 状态将保持不变。
         if (_receiver.ackno().has_value() || _sender.bytes_in_flight() > 0) {
-            _sender.ack_received(seg.header().ackno, seg.header().win);
+            // SYN 中的窗口不缩放
+            const uint64_t window = seg.header().syn ? seg.header().win
+                                                     : uint64_t{seg.header().win} << _snd_window_shift;
+            // 协商了 SACK：把对端的 SACK 块交给 TCPSender 的记分板；协商了时间戳：把回显交给它测量 RTT
+            static const vector<TCPHeader::SackBlock> no_sack_blocks{};
+            const auto &sack_blocks = _sack_enabled ? seg.header().sack_blocks : no_sack_blocks;
+            optional<uint32_t> timestamp_echo{};
+            if (_timestamps_enabled && seg.header().timestamps.has_value()) {
+                timestamp_echo = seg.header().timestamps.value().ecr;
+            }
+            // 对端发送自己的数据时会重复同一个确认号，这样的段不是重复 ACK
+            const bool pure_ack = seg.length_in_sequence_space() == 0;
+            _sender.ack_received(seg.header().ackno, window, sack_blocks, timestamp_echo, pure_ack);
         }
     }
     
@@ -149,9 +372,22 @@ void TCPConnection::segment_received(const TCPSegment &seg) {
     if (_segments_out.size() == segments_out_size_before) {
         // 【修正 1.3】: 仅在接收到的段占用了序列空间时才发送纯 ACK，以避免冗余 ACK 错误。
         if (original_seg.length_in_sequence_space() > 0) {
-            // 发送一个空的 ACK 数据段 (用于 keep-alive 或 纯ACK 响应)
-            _sender.send_empty_segment();
-            send_segments_from_sender();
+            // 延迟 ACK：只推迟按序到达、被完整接收的数据段的 ACK；乱序的段、填补空洞的段、重复的段
+            // (确认号没有前进) 以及 SYN/FIN 都立即确认，让对端尽快得知丢失或者连接状态的变化
+            const bool in_order = ackno_before.has_value() && !seg.header().syn && !seg.header().fin &&
+                                  _receiver.ackno() == ackno_before.value() + seg.length_in_sequence_space() &&
+                                  unassembled_before == 0 && _receiver.unassembled_bytes() == 0;
+            if (_cfg.delayed_ack && in_order) {
+                _unacked_bytes += seg.payload().size();
+                if (!_ack_delayed_ms.has_value()) {
+                    _ack_delayed_ms = 0;
+                }
+            }
+            // 收到的数据超过一个满长度的段 (即每两个满长度的段) 就确认
+            if (!_cfg.delayed_ack || !in_order || _unacked_bytes > _cfg.mss) {
+                // 发送一个空的 ACK 数据段 (用于 keep-alive 或 纯ACK 响应)
+                send_ack();
+            }
         }
     }
     
@@ -163,9 +399,7 @@ bool TCPConnection::active() const {
     if(!_is_active)
         return false;
 
-    if (_receiver.stream_out().input_ended() && 
-        _sender.stream_in().input_ended() && 
-        _sender.bytes_in_flight() == 0) {
+    if (streams_finished()) {
         
         // 如果处于 TIME_WAIT 状态（_linger_after_streams_finish 为 true），则 active 只有在超时后才变为 false
         if (_linger_after_streams_finish) {
@@ -194,6 +428,18 @@ size_t TCPConnection::write(const string &data) {
     return written;
 }
 
+size_t TCPConnection::write_from(FileDescriptor &fd, const size_t limit) {
+    // 直接从 fd 读入发送方的出站流，省去中间的 std::string
+    const size_t written = _sender.stream_in().write_from(fd, limit);
+
+    _sender.fill_window();
+    send_segments_from_sender();
+
+    check_for_shutdown();
+
+    return written;
+}
+
 //! \param[in] ms_since_last_tick number of milliseconds since the last call to this method
 void TCPConnection::tick(const size_t ms_since_last_tick) {
     // 1. 告诉TCPSender时间的流逝。
@@ -208,15 +454,25 @@ void TCPConnection::tick(const size_t ms_since_last_tick) {
     // 更新时间
     _time_since_last_segment_received_ms += ms_since_last_tick;
 
+    autotune_buffers(ms_since_last_tick);
+
+    // 应用读走数据后窗口变大了，主动通告，不必等对端的窗口探测
+    check_window_update();
+
     // 尝试发送任何因重传而产生的段
     send_segments_from_sender();
 
+    // 推迟的 ACK 到期 (如果上面发出了段，ACK 已经随之发出)
+    if (_ack_delayed_ms.has_value()) {
+        _ack_delayed_ms = _ack_delayed_ms.value() + ms_since_last_tick;
+        if (_ack_delayed_ms.value() >= _cfg.delayed_ack_timeout) {
+            send_ack();
+        }
+    }
+
     // 3. 如有必要，结束连接。 (Linger Timeout check)
     // 检查是否满足优雅关闭条件，且处于 TIME_WAIT (linger=true) 状态
-    if (_receiver.stream_out().input_ended() && 
-        _sender.stream_in().input_ended() && 
-        _sender.bytes_in_flight() == 0 &&
-        _linger_after_streams_finish) {
+    if (streams_finished() && _linger_after_streams_finish) {
         
         // d.i: 需要停留 10 * _cfg.rt_timeout 时间后结束
         if (_time_since_last_segment_received_ms >= 10 * _cfg.rt_timeout) {
@@ -225,6 +481,44 @@ void TCPConnection::tick(const size_t ms_since_last_tick) {
     }
 }
 
+optional<size_t> TCPConnection::next_timeout() const {
+    if (!active()) {
+        return {};
+    }
+    optional<size_t> timeout = _sender.next_timeout();
+    // 推迟的 ACK 到期的时间
+    if (_ack_delayed_ms.has_value()) {
+        const size_t ack_delay = _cfg.delayed_ack_timeout;
+        const size_t ack_remaining = ack_delay > _ack_delayed_ms.value() ? ack_delay - _ack_delayed_ms.value() : 0;
+        timeout = min(timeout.value_or(ack_remaining), ack_remaining);
+    }
+    // TIME_WAIT：逗留结束的时间
+    if (streams_finished() && _linger_after_streams_finish) {
+        const size_t linger = 10 * _cfg.rt_timeout;
+        const size_t linger_remaining =
+            linger > _time_since_last_segment_received_ms ? linger - _time_since_last_segment_received_ms : 0;
+        timeout = min(timeout.value_or(linger_remaining), linger_remaining);
+    }
+    // 缓冲区自动调整：这一轮测量结束的时间 (缓冲区排空、这一轮也没有读走数据时没有可测的，不必唤醒)，
+    // 以及排空之后开始缩小缓冲区的时间
+    if (_cfg.autotune_buffers) {
+        const optional<double> srtt = _sender.rtt_estimator().srtt();
+        const bool measuring = !buffers_drained() || _receiver.stream_out().bytes_read() != _autotune_bytes_read;
+        if (srtt.has_value() && measuring) {
+            const size_t round = static_cast<size_t>(ceil(max(srtt.value(), 1.0)));
+            const size_t round_remaining = round > _autotune_round_ms ? round - _autotune_round_ms : 0;
+            timeout = min(timeout.value_or(round_remaining), round_remaining);
+        }
+        const bool grown = _receiver.capacity() > _cfg.recv_capacity ||
+                           _sender.stream_in().capacity() > _cfg.send_capacity;
+        if (grown && buffers_drained() && _time_since_last_segment_received_ms < _cfg.rt_timeout) {
+            const size_t idle_remaining = _cfg.rt_timeout - _time_since_last_segment_received_ms;
+            timeout = min(timeout.value_or(idle_remaining), idle_remaining);
+        }
+    }
+    return timeout;
+}
+
 void TCPConnection::end_input_stream() {
     // 1. Shut down the outbound byte stream
     _sender.stream_in().end_input();
@@ -249,9 +543,7 @@ void TCPConnection::connect() {
 TCPConnection::~TCPConnection() {
     try {
         // 检查是否满足优雅关闭的条件
-        bool streams_ended_gracefully = _receiver.stream_out().input_ended() && 
-                                        _sender.stream_in().input_ended() && 
-                                        _sender.bytes_in_flight() == 0;
+        bool streams_ended_gracefully = streams_finished();
 
         // 【修正 2.1】: 仅在 active() 为 true 且**未达到优雅关闭条件**时，才执行“非正常关闭”。
         // 如果 active() 为 true 且已达到优雅关闭条件 (streams_ended_gracefully 为 true)，则处于 TIME-WAIT 状态，不发送 RST。
@@ -10,8 +10,8 @@
 class TCPConnection {
   private:
     TCPConfig _cfg;
-    TCPReceiver _receiver{_cfg.recv_capacity};
-    TCPSender _sender{_cfg.send_capacity, _cfg.rt_timeout, _cfg.fixed_isn};
+    TCPReceiver _receiver{_cfg.recv_capacity, _cfg.storage_for(_cfg.recv_capacity)};
+    TCPSender _sender{_cfg};
 
     //! outbound queue of segments that the TCPConnection wants sent
     std::queue<TCPSegment> _segments_out{};
@@ -24,8 +24,46 @@ class TCPConnection {
 
     size_t _time_since_last_segment_received_ms{0};
 
+    //! Both ends offered SACK in their SYNs, so outgoing segments carry SACK blocks
+    bool _sack_enabled{false};
+
+    //! Both ends offered window scaling in their SYNs: windows we advertise are shifted right by
+    //! `_rcv_window_shift`, and windows the peer advertises are shifted left by `_snd_window_shift`
+    bool _window_scaling_enabled{false};
+    uint8_t _rcv_window_shift{0};
+    uint8_t _snd_window_shift{0};
+
+    //! Both ends offered timestamps in their SYNs: every segment carries TSval and TSecr, and segments
+    //! whose TSval is older than `_ts_recent` are discarded (PAWS)
+    bool _timestamps_enabled{false};
+    uint32_t _ts_recent{0};                         //!< TSval to echo (TS.Recent)
+    std::optional<WrappingInt32> _last_ack_sent{};  //!< ackno of the last segment we sent
+
+    //! Furthest right edge of a window we have advertised (ackno + window): the peer may send up to it, and
+    //! reads must open the window enough past it to be worth a window update
+    std::optional<WrappingInt32> _last_window_edge{};
+
+    //! Delayed ACK: how long ago the oldest data not yet ACKed arrived, and how many bytes have arrived since
+    //! the last ACK. Any segment we send carries the ACK and clears both.
+    std::optional<size_t> _ack_delayed_ms{};
+    size_t _unacked_bytes{0};
+
+    //! Buffer autotuning: time into the current measurement round (one SRTT long), and the inbound stream's
+    //! bytes_read() when the round began
+    size_t _autotune_round_ms{0};
+    uint64_t _autotune_bytes_read{0};
+    //! Capacity an idle receive buffer is shrinking to, as fast as the window already advertised allows
+    std::optional<size_t> _recv_capacity_target{};
+
     void send_segments_from_sender();
     void send_rst_and_die();
+    bool check_timestamps(const TCPSegment &seg);
+    void send_ack();
+    size_t max_recv_capacity() const;
+    bool buffers_drained() const;
+    void autotune_buffers(const size_t ms_since_last_tick);
+    void shrink_receive_buffer();
+    bool streams_finished() const;
     void check_for_shutdown();
 
   public:
@@ -39,6 +77,10 @@ class TCPConnection {
     //! \returns the number of bytes from `data` that were actually written.
     size_t write(const std::string &data);
 
+    //! \brief Read data from `fd` straight into the outbound byte stream, and send it over TCP if possible
+    //! \returns the number of bytes read from `fd`
+    size_t write_from(FileDescriptor &fd, const size_t limit);
+
     //! \returns the number of `bytes` that can be written right now.
     size_t remaining_outbound_capacity() const;
 
@@ -51,6 +93,14 @@ class TCPConnection {
 
     //! \brief The inbound byte stream received from the peer
     ByteStream &inbound_stream() { return _receiver.stream_out(); }
+
+    //! \brief Send a window update if reads from inbound_stream() have opened the receive window enough
+    //! \details Following the receiver's silly-window-syndrome avoidance in [RFC 1122](\ref rfc::rfc1122)
+    //! (section 4.2.3.3), the right edge of the window must have moved by at least the smaller of an MSS and
+    //! half the receive buffer since it was last advertised. Without the update, a sender stopped by a zero
+    //! window learns of the space only from its window probes. tick() checks too, so calling this after
+    //! reading only makes the update go out sooner.
+    void check_window_update();
     //!@}
 
     //! \name Accessors used for testing
@@ -62,6 +112,15 @@ class TCPConnection {
     size_t unassembled_bytes() const;
     //! \brief Number of milliseconds since the last segment was received
     size_t time_since_last_segment_received() const;
+    //! \brief Milliseconds until pacing lets the next segment go, if one is waiting for it
+    std::optional<size_t> next_send_delay() const { return _sender.next_send_delay(); }
+    //! \brief Milliseconds until tick() next has work to do (retransmission, paced data, a delayed ACK, the
+    //! end of an autotuning round or of a grown buffer's idle period, or the end of lingering), or nothing if
+    //! the connection is waiting only for segments or the application
+    //! \details A host of many connections can keep these deadlines in a TimerWheel and tick a connection
+    //! only when its deadline passes (and before giving it a segment), instead of ticking every connection
+    //! on every pass of its event loop.
+    std::optional<size_t> next_timeout() const;
     //!< \brief summarize the state of the sender, receiver, and the connection
     TCPState state() const { return {_sender, _receiver, active(), _linger_after_streams_finish}; };
     //!@}
@@ -2,6 +2,7 @@
 #define SPONGE_LIBSPONGE_FD_ADAPTER_HH
 
 #include "file_descriptor.hh"
+#include "ipv4_header.hh"
 #include "lossy_fd_adapter.hh"
 #include "socket.hh"
 #include "tcp_config.hh"
@@ -48,9 +49,16 @@ class TCPOverUDPSocketAdapter : public FdAdapterBase {
     UDPSocket _sock;
 
   public:
+    static constexpr size_t UDP_HEADER_LENGTH = 8;  //!< UDP header length
+
     //! Construct from a UDPSocket sliced into a FileDescriptor
     explicit TCPOverUDPSocketAdapter(UDPSocket &&sock) : _sock(std::move(sock)) {}
 
+    //! Largest TCP payload that fits in one IPv4 datagram of the configured MTU, after the UDP header
+    uint16_t max_segment_size() const {
+        return config().mtu - IPv4Header::LENGTH - UDP_HEADER_LENGTH - TCPHeader::LENGTH;
+    }
+
     //! Attempts to read and return a TCP segment related to the current connection from a UDP payload
     std::optional<TCPSegment> read();
 
@@ -2,10 +2,13 @@
 #define SPONGE_LIBSPONGE_TCP_CONFIG_HH
 
 #include "address.hh"
+#include "byte_stream.hh"
+#include "congestion_control.hh"
 #include "wrapping_integers.hh"
 
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <optional>
 
 //! Config for TCP sender and receiver
@@ -15,19 +18,96 @@ class TCPConfig {
     static constexpr size_t MAX_PAYLOAD_SIZE = 1000;   //!< Conservative max payload size for real Internet
     static constexpr uint16_t TIMEOUT_DFLT = 1000;     //!< Default re-transmit timeout is 1 second
     static constexpr unsigned MAX_RETX_ATTEMPTS = 8;   //!< Maximum re-transmit attempts before giving up
+    static constexpr uint16_t MIN_RTO_DFLT = 200;      //!< Default lower bound on an adaptive RTO
+    static constexpr uint32_t MAX_RTO_DFLT = 60000;    //!< Default upper bound on an adaptive RTO
+    static constexpr uint16_t DELAYED_ACK_DFLT = 40;   //!< Default longest delay of a delayed ACK
+    static constexpr size_t MAX_AUTOTUNED = 4 << 20;   //!< Default cap on an autotuned stream capacity
 
     uint16_t rt_timeout = TIMEOUT_DFLT;       //!< Initial value of the retransmission timeout, in milliseconds
     size_t recv_capacity = DEFAULT_CAPACITY;  //!< Receive capacity, in bytes
     size_t send_capacity = DEFAULT_CAPACITY;  //!< Sender capacity, in bytes
     std::optional<WrappingInt32> fixed_isn{};
+
+    //! Largest payload to put in one segment. It is offered to the peer in the SYN's MSS option, and the
+    //! sender uses the smaller of it and the peer's offer (or MAX_PAYLOAD_SIZE, if the peer makes none).
+    uint16_t mss = MAX_PAYLOAD_SIZE;
+
+    //! Compute the retransmission timeout from measured RTTs ([RFC 6298](\ref rfc::rfc6298)),
+    //! starting from `rt_timeout`, instead of always restarting the timer from `rt_timeout`
+    bool adaptive_rto = false;
+    uint16_t min_rto = MIN_RTO_DFLT;  //!< Lower bound on an adaptive RTO, in milliseconds
+    uint32_t max_rto = MAX_RTO_DFLT;  //!< Upper bound on an adaptive RTO, in milliseconds
+
+    //! Retransmit after three duplicate ACKs and recover with NewReno
+    //! ([RFC 5681](\ref rfc::rfc5681), [RFC 6582](\ref rfc::rfc6582)) instead of waiting for the RTO
+    bool fast_retransmit = false;
+
+    //! Offer [SACK](\ref rfc::rfc2018) in the SYN, and report out-of-order data in SACK options
+    //! on outgoing segments if the peer offers it too
+    bool sack = false;
+
+    //! Offer [window scaling](\ref rfc::rfc7323) in the SYN, so that windows larger than 64 KiB can be
+    //! advertised and used if the peer offers it too
+    bool window_scaling = false;
+
+    //! Offer [timestamps](\ref rfc::rfc7323) in the SYN. If the peer offers them too, every segment carries
+    //! them: the sender takes an RTT sample from every ACK, and old duplicate segments are discarded (PAWS)
+    bool timestamps = false;
+
+    //! Congestion-control algorithm for the sender; with None, only the receiver's window limits it
+    CongestionControl::Algorithm congestion_control = CongestionControl::Algorithm::None;
+
+    //! Spread segments out over the round trip instead of sending a whole window at once: at the congestion
+    //! controller's pacing rate if it has one, otherwise at the window divided by the smoothed RTT
+    bool pacing = false;
+
+    //! Detect losses by time rather than by counting duplicate ACKs, and probe for a lost tail of a flight
+    //! after two smoothed RTTs instead of waiting for the retransmission timeout
+    //! (RACK-TLP, [RFC 8985](\ref rfc::rfc8985))
+    bool rack_tlp = false;
+
+    //! Delay the ACK for in-order data ([RFC 1122](\ref rfc::rfc1122), [RFC 5681](\ref rfc::rfc5681)), so
+    //! that one ACK covers every second full-sized segment, or goes out `delayed_ack_timeout` ms after the
+    //! data arrived. Out-of-order data, a segment that fills a hole, and a SYN or FIN are still ACKed at once.
+    bool delayed_ack = false;
+    uint16_t delayed_ack_timeout = DELAYED_ACK_DFLT;  //!< Longest delay of an ACK, in milliseconds
+
+    //! Size the stream buffers to the connection, starting from `recv_capacity` and `send_capacity`. Once
+    //! per RTT, the receive buffer grows to twice what the application read in that RTT (so the window keeps
+    //! ahead of a sender that is still speeding up), and the send buffer grows to twice the sending window.
+    //! After an idle `rt_timeout`, the send buffer goes back to its starting size, and so does the receive
+    //! buffer, as fast as the peer uses up the window it was already offered (which is never retracted).
+    bool autotune_buffers = false;
+    size_t max_recv_capacity = MAX_AUTOTUNED;  //!< Largest receive capacity autotuning grows to, in bytes
+    size_t max_send_capacity = MAX_AUTOTUNED;  //!< Largest send capacity autotuning grows to, in bytes
+
+    //! Streams whose capacity exceeds this many bytes keep their bytes in a memory-mapped
+    //! temporary file (ByteStream::Storage::MappedFile) instead of pinned memory
+    size_t spill_threshold = std::numeric_limits<size_t>::max();
+
+    //! \returns the ByteStream storage to use for a stream of `capacity` bytes
+    ByteStream::Storage storage_for(const size_t capacity) const {
+        return capacity > spill_threshold ? ByteStream::Storage::MappedFile : ByteStream::Storage::Ring;
+    }
+
+    //! \returns the ByteStream storage for the sender's outgoing stream: a chain of shared Buffers, so that
+    //! segments can be cut from the written bytes without copying them, unless the stream should spill
+    ByteStream::Storage send_storage() const {
+        return send_capacity > spill_threshold ? ByteStream::Storage::MappedFile : ByteStream::Storage::BufferChain;
+    }
 };
 
 //! Config for classes derived from FdAdapter
 class FdAdapterConfig {
   public:
+    static constexpr uint16_t DEFAULT_MTU = 1500;  //!< Ethernet's MTU
+
     Address source{"0", 0};       //!< Source address and port
     Address destination{"0", 0};  //!< Destination address and port
 
+    //! Largest IPv4 datagram the adapter sends, counting every header (for TCP over UDP, the IPv4 and UDP ones)
+    uint16_t mtu = DEFAULT_MTU;
+
     uint16_t loss_rate_dn = 0;  //!< Downlink loss rate (for LossyFdAdapter)
     uint16_t loss_rate_up = 0;  //!< Uplink loss rate (for LossyFdAdapter)
 };
@@ -1,5 +1,6 @@
 #include "tcp_header.hh"
 
+#include <algorithm>
 #include <sstream>
 
 using namespace std;
@@ -37,8 +38,8 @@ ParseResult TCPHeader::parse(NetParser &p) {
         return ParseResult::HeaderTooShort;
     }
 
-    // skip any options or anything extra in the header
-    p.remove_prefix(doff * 4 - TCPHeader::LENGTH);
+    // parse the options, skipping any we don't understand
+    parse_options(p, doff * 4 - TCPHeader::LENGTH);
 
     if (p.error()) {
         return p.get_error();
@@ -47,6 +48,120 @@ ParseResult TCPHeader::parse(NetParser &p) {
     return ParseResult::NoError;
 }
 
+namespace {
+//! Option kinds, from the [IANA registry](https://www.iana.org/assignments/tcp-parameters)
+enum TCPOptionKind : uint8_t {
+    END_OF_OPTIONS = 0,
+    NO_OPERATION = 1,
+    MAXIMUM_SEGMENT_SIZE = 2,
+    WINDOW_SCALE = 3,
+    SACK_PERMITTED = 4,
+    SACK = 5,
+    TIMESTAMPS = 8
+};
+}  // namespace
+
+//! \param[in,out] p is a NetParser positioned at the start of the options
+//! \param[in] len is the length of the options area, in bytes
+void TCPHeader::parse_options(NetParser &p, const size_t len) {
+    size_t remaining = len;
+    while (remaining > 0 and not p.error()) {
+        const uint8_t kind = p.u8();
+        remaining--;
+        if (kind == END_OF_OPTIONS) {
+            break;
+        }
+        if (kind == NO_OPERATION) {
+            continue;
+        }
+
+        // every other option has a length byte, which counts the kind and length bytes themselves
+        if (remaining == 0) {
+            break;
+        }
+        const uint8_t opt_len = p.u8();
+        remaining--;
+        if (opt_len < 2 or opt_len - 2U > remaining) {
+            // malformed: ignore the rest of the options, as other stacks do
+            break;
+        }
+        const size_t body_len = opt_len - 2;
+        remaining -= body_len;
+
+        if (kind == MAXIMUM_SEGMENT_SIZE and body_len == 2) {
+            mss = p.u16();
+        } else if (kind == WINDOW_SCALE and body_len == 1) {
+            window_scale = p.u8();
+        } else if (kind == SACK_PERMITTED and body_len == 0) {
+            sack_permitted = true;
+        } else if (kind == TIMESTAMPS and body_len == 8) {
+            const uint32_t val = p.u32();
+            const uint32_t ecr = p.u32();
+            timestamps = Timestamps{val, ecr};
+        } else if (kind == SACK and body_len % 8 == 0) {
+            for (size_t i = 0; i < body_len / 8; i++) {
+                const WrappingInt32 left{p.u32()};
+                const WrappingInt32 right{p.u32()};
+                sack_blocks.push_back({left, right});
+            }
+        } else {
+            p.remove_prefix(body_len);
+        }
+    }
+
+    // skip the padding, and whatever follows a malformed option
+    p.remove_prefix(remaining);
+}
+
+string TCPHeader::serialize_options() const {
+    string ret;
+    if (mss.has_value()) {
+        NetUnparser::u8(ret, MAXIMUM_SEGMENT_SIZE);
+        NetUnparser::u8(ret, 4);
+        NetUnparser::u16(ret, mss.value());
+    }
+    if (window_scale.has_value()) {
+        NetUnparser::u8(ret, NO_OPERATION);
+        NetUnparser::u8(ret, WINDOW_SCALE);
+        NetUnparser::u8(ret, 3);
+        NetUnparser::u8(ret, window_scale.value());
+    }
+    if (sack_permitted) {
+        NetUnparser::u8(ret, SACK_PERMITTED);
+        NetUnparser::u8(ret, 2);
+    }
+    if (timestamps.has_value()) {
+        // the layout [RFC 7323](\ref rfc::rfc7323) recommends: two NOPs, then the option, 32-bit aligned
+        NetUnparser::u8(ret, NO_OPERATION);
+        NetUnparser::u8(ret, NO_OPERATION);
+        NetUnparser::u8(ret, TIMESTAMPS);
+        NetUnparser::u8(ret, 10);
+        NetUnparser::u32(ret, timestamps.value().val);
+        NetUnparser::u32(ret, timestamps.value().ecr);
+    }
+    if (not sack_blocks.empty()) {
+        const size_t max_blocks = timestamps.has_value() ? MAX_SACK_BLOCKS_WITH_TIMESTAMPS : MAX_SACK_BLOCKS;
+        const size_t n_blocks = min(sack_blocks.size(), max_blocks);
+        // two NOPs keep the blocks 32-bit aligned, as [RFC 2018](\ref rfc::rfc2018) suggests
+        NetUnparser::u8(ret, NO_OPERATION);
+        NetUnparser::u8(ret, NO_OPERATION);
+        NetUnparser::u8(ret, SACK);
+        NetUnparser::u8(ret, 2 + 8 * n_blocks);
+        for (size_t i = 0; i < n_blocks; i++) {
+            NetUnparser::u32(ret, sack_blocks[i].left.raw_value());
+            NetUnparser::u32(ret, sack_blocks[i].right.raw_value());
+        }
+    }
+
+    if (ret.size() > MAX_OPTIONS_LENGTH) {
+        throw runtime_error("TCP options too long");
+    }
+    ret.resize((ret.size() + 3) / 4 * 4, END_OF_OPTIONS);
+    return ret;
+}
+
+size_t TCPHeader::length() const { return max(4 * size_t{doff}, LENGTH + serialize_options().size()); }
+
 //! Serialize the TCPHeader to a string (does not recompute the checksum)
 string TCPHeader::serialize() const {
     // sanity check
@@ -54,14 +169,17 @@ string TCPHeader::serialize() const {
         throw runtime_error("TCP header too short");
     }
 
+    const string options = serialize_options();
+    const size_t header_length = max(4 * size_t{doff}, LENGTH + options.size());
+
     string ret;
-    ret.reserve(4 * doff);
+    ret.reserve(header_length);
 
     NetUnparser::u16(ret, sport);              // source port
     NetUnparser::u16(ret, dport);              // destination port
     NetUnparser::u32(ret, seqno.raw_value());  // sequence number
     NetUnparser::u32(ret, ackno.raw_value());  // ack number
-    NetUnparser::u8(ret, doff << 4);           // data offset
+    NetUnparser::u8(ret, header_length / 4 << 4);  // data offset
 
     const uint8_t fl_b = (urg ? 0b0010'0000 : 0) | (ack ? 0b0001'0000 : 0) | (psh ? 0b0000'1000 : 0) |
                          (rst ? 0b0000'0100 : 0) | (syn ? 0b0000'0010 : 0) | (fin ? 0b0000'0001 : 0);
@@ -72,7 +190,8 @@ string TCPHeader::serialize() const {
 
     NetUnparser::u16(ret, uptr);  // urgent pointer
 
-    ret.resize(4 * doff);  // expand header to advertised size
+    ret.append(options);
+    ret.resize(header_length);  // expand header to advertised size
 
     return ret;
 }
@@ -89,7 +208,17 @@ string TCPHeader::to_string() const {
        << " fin: " << fin << '\n'
        << "TCP winsize: " << +win << '\n'
        << "TCP cksum: " << +cksum << '\n'
-       << "TCP uptr: " << +uptr << '\n';
+       << "TCP uptr: " << +uptr << '\n'
+       << "TCP mss: " << dec << (mss.has_value() ? std::to_string(mss.value()) : "none") << hex << '\n'
+       << "TCP window scale: " << dec << (window_scale.has_value() ? std::to_string(+window_scale.value()) : "none")
+       << hex << '\n'
+       << "TCP sack permitted: " << sack_permitted << '\n'
+       << "TCP timestamps: " << dec
+       << (timestamps.has_value()
+               ? std::to_string(timestamps.value().val) + " echo " + std::to_string(timestamps.value().ecr)
+               : "none")
+       << hex << '\n'
+       << "TCP sack blocks: " << dec << sack_blocks.size() << '\n';
     return ss.str();
 }
 
@@ -104,5 +233,7 @@ bool TCPHeader::operator==(const TCPHeader &other) const {
     // TODO(aozdemir) more complete check (right now we omit cksum, src, dst
     return seqno == other.seqno && ackno == other.ackno && doff == other.doff && urg == other.urg && ack == other.ack &&
            psh == other.psh && rst == other.rst && syn == other.syn && fin == other.fin && win == other.win &&
-           uptr == other.uptr;
+           uptr == other.uptr && mss == other.mss && window_scale == other.window_scale &&
+           sack_permitted == other.sack_permitted && timestamps == other.timestamps &&
+           sack_blocks == other.sack_blocks;
 }
@@ -4,10 +4,37 @@
 #include "parser.hh"
 #include "wrapping_integers.hh"
 
+#include <optional>
+#include <vector>
+
 //! \brief [TCP](\ref rfc::rfc793) segment header
-//! \note TCP options are not supported
+//! \note Only the options listed under "TCP options" are understood; others are skipped when parsing
 struct TCPHeader {
     static constexpr size_t LENGTH = 20;  //!< [TCP](\ref rfc::rfc793) header length, not including options
+    static constexpr size_t MAX_OPTIONS_LENGTH = 40;  //!< Most option bytes that fit in the data offset
+    static constexpr size_t MAX_SACK_BLOCKS = 4;      //!< Most SACK blocks that fit in the options
+    static constexpr size_t TIMESTAMPS_LENGTH = 12;   //!< Option bytes the timestamps option takes, padding included
+    static constexpr uint8_t MAX_WINDOW_SCALE = 14;   //!< Largest window shift [RFC 7323](\ref rfc::rfc7323) allows
+    //! Most SACK blocks that fit in the options next to the timestamps option
+    static constexpr size_t MAX_SACK_BLOCKS_WITH_TIMESTAMPS = 3;
+
+    //! \brief One block of a [SACK](\ref rfc::rfc2018) option: the sequence numbers [left, right)
+    //! have arrived, out of order
+    struct SackBlock {
+        WrappingInt32 left;   //!< first sequence number of the block
+        WrappingInt32 right;  //!< one past the last sequence number of the block
+
+        bool operator==(const SackBlock &other) const { return left == other.left and right == other.right; }
+    };
+
+    //! \brief The [timestamps](\ref rfc::rfc7323) option: the sender's clock, and the most recent
+    //! timestamp it received from the peer
+    struct Timestamps {
+        uint32_t val = 0;  //!< TSval: the sender's timestamp clock when the segment was sent
+        uint32_t ecr = 0;  //!< TSecr: echo of the peer's TSval (only meaningful if the ACK flag is set)
+
+        bool operator==(const Timestamps &other) const { return val == other.val and ecr == other.ecr; }
+    };
 
     //! \struct TCPHeader
     //! ~~~{.txt}
@@ -50,10 +77,24 @@ struct TCPHeader {
     uint16_t uptr = 0;          //!< urgent pointer
     //!@}
 
+    //! \name TCP options
+    //!@{
+    std::optional<uint16_t> mss{};           //!< Maximum segment size option (only meaningful on a SYN)
+    std::optional<uint8_t> window_scale{};   //!< Window scale option: the shift count (only meaningful on a SYN)
+    bool sack_permitted = false;             //!< SACK-permitted option (only meaningful on a SYN)
+    std::optional<Timestamps> timestamps{};  //!< Timestamps option: TSval and TSecr
+    //! SACK option; at most MAX_SACK_BLOCKS blocks are sent, or MAX_SACK_BLOCKS_WITH_TIMESTAMPS next to timestamps
+    std::vector<SackBlock> sack_blocks{};
+    //!@}
+
+    //! \returns the length of the serialized header, in bytes: `doff` words, or more if the options need it
+    size_t length() const;
+
     //! Parse the TCP fields from the provided NetParser
     ParseResult parse(NetParser &p);
 
     //! Serialize the TCP fields
+    //! \note The data offset written is length() / 4, which accounts for the options
     std::string serialize() const;
 
     //! Return a string containing a header in human-readable format
@@ -63,6 +104,13 @@ struct TCPHeader {
     std::string summary() const;
 
     bool operator==(const TCPHeader &other) const;
+
+  private:
+    //! Parse the options area, which is `len` bytes long
+    void parse_options(NetParser &p, const size_t len);
+
+    //! Serialize the options, padded to a whole number of 32-bit words
+    std::string serialize_options() const;
 };
 
 #endif  // SPONGE_LIBSPONGE_TCP_HEADER_HH
@@ -14,6 +14,9 @@ class TCPOverIPv4Adapter : public FdAdapterBase {
     std::optional<TCPSegment> unwrap_tcp_in_ip(const InternetDatagram &ip_dgram);
 
     InternetDatagram wrap_tcp_in_ip(TCPSegment &seg);
+
+    //! Largest TCP payload that fits in one datagram of the configured MTU
+    uint16_t max_segment_size() const { return config().mtu - IPv4Header::LENGTH - TCPHeader::LENGTH; }
 };
 
 #endif  // SPONGE_LIBSPONGE_TCP_OVER_IP_HH
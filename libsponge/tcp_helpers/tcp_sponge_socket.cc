@@ -25,7 +25,12 @@ template <typename AdaptT>
 void TCPSpongeSocket<AdaptT>::_tcp_loop(const function<bool()> &condition) {
     auto base_time = timestamp_ms();
     while (condition()) {
-        auto ret = _eventloop.wait_next_event(TCP_TICK_MS);
+        // wake up early if a paced segment, a delayed ACK or another timer is due before the next tick
+        size_t timeout_ms = TCP_TICK_MS;
+        if (_tcp.has_value()) {
+            timeout_ms = min(timeout_ms, _tcp.value().next_timeout().value_or(TCP_TICK_MS));
+        }
+        auto ret = _eventloop.wait_next_event(timeout_ms);
         if (ret == EventLoop::Result::Exit or _abort) {
             break;
         }
@@ -52,7 +57,10 @@ TCPSpongeSocket<AdaptT>::TCPSpongeSocket(pair<FileDescriptor, FileDescriptor> da
 
 template <typename AdaptT>
 void TCPSpongeSocket<AdaptT>::_initialize_TCP(const TCPConfig &config) {
-    _tcp.emplace(config);
+    // segments must fit in the adapter's datagrams
+    TCPConfig tcp_config = config;
+    tcp_config.mss = min(tcp_config.mss, _datagram_adapter.max_segment_size());
+    _tcp.emplace(tcp_config);
 
     // Set up the event loop
 
@@ -96,12 +104,7 @@ void TCPSpongeSocket<AdaptT>::_initialize_TCP(const TCPConfig &config) {
         _thread_data,
         Direction::In,
         [&] {
-            const auto data = _thread_data.read(_tcp->remaining_outbound_capacity());
-            const auto len = data.size();
-            const auto amount_written = _tcp->write(move(data));
-            if (amount_written != len) {
-                throw runtime_error("TCPConnection::write() accepted less than advertised length");
-            }
+            _tcp->write_from(_thread_data, _tcp->remaining_outbound_capacity());
 
             if (_thread_data.eof()) {
                 _tcp->end_input_stream();
@@ -128,10 +131,9 @@ void TCPSpongeSocket<AdaptT>::_initialize_TCP(const TCPConfig &config) {
             // Write from the inbound_stream into
             // the pipe, handling the possibility of a partial
             // write (i.e., only pop what was actually written).
-            const size_t amount_to_write = min(size_t(65536), inbound.buffer_size());
-            const std::string buffer = inbound.peek_output(amount_to_write);
-            const auto bytes_written = _thread_data.write(move(buffer), false);
-            inbound.pop_output(bytes_written);
+            inbound.read_into(_thread_data, 65536);
+            // the read may have opened a closed window; tell the peer now rather than at the next tick
+            _tcp->check_window_update();
 
             if (inbound.eof() or inbound.error()) {
                 _thread_data.shutdown(SHUT_WR);
@@ -208,10 +210,10 @@ void TCPSpongeSocket<AdaptT>::connect(const TCPConfig &c_tcp, const FdAdapterCon
         throw runtime_error("connect() with TCPConnection already initialized");
     }
 
-    _initialize_TCP(c_tcp);
-
     _datagram_adapter.config_mut() = c_ad;
 
+    _initialize_TCP(c_tcp);
+
     cerr << "DEBUG: Connecting to " << c_ad.destination.to_string() << "...\n";
     _tcp->connect();
 
@@ -236,11 +238,11 @@ void TCPSpongeSocket<AdaptT>::listen_and_accept(const TCPConfig &c_tcp, const Fd
         throw runtime_error("listen_and_accept() with TCPConnection already initialized");
     }
 
-    _initialize_TCP(c_tcp);
-
     _datagram_adapter.config_mut() = c_ad;
     _datagram_adapter.set_listening(true);
 
+    _initialize_TCP(c_tcp);
+
     cerr << "DEBUG: Listening for incoming connection...\n";
     _tcp_loop([&] {
         const auto s = _tcp->state();
@@ -9,8 +9,9 @@ using namespace std;
 TCPOverIPv4OverEthernetAdapter::TCPOverIPv4OverEthernetAdapter(TapFD &&tap,
                                                                const EthernetAddress &eth_address,
                                                                const Address &ip_address,
-                                                               const Address &next_hop)
-    : _tap(move(tap)), _interface(eth_address, ip_address), _next_hop(next_hop) {
+                                                               const Address &next_hop,
+                                                               const size_t mtu)
+    : _tap(move(tap)), _interface(eth_address, ip_address, mtu), _next_hop(next_hop) {
     // Linux seems to ignore the first frame sent on a TAP device, so send a dummy frame to prime the pump :-(
     EthernetFrame dummy_frame;
     _tap.write(dummy_frame.serialize());
@@ -5,6 +5,7 @@
 #include "network_interface.hh"
 #include "tun.hh"
 
+#include <algorithm>
 #include <optional>
 #include <unordered_map>
 #include <utility>
@@ -52,11 +53,12 @@ class TCPOverIPv4OverEthernetAdapter : public TCPOverIPv4Adapter {
     void send_pending();  //!< Sends any pending Ethernet frames
 
   public:
-    //! Construct from a TapFD
+    //! Construct from a TapFD, for a link that carries IPv4 datagrams of up to `mtu` bytes
     explicit TCPOverIPv4OverEthernetAdapter(TapFD &&tap,
                                             const EthernetAddress &eth_address,
                                             const Address &ip_address,
-                                            const Address &next_hop);
+                                            const Address &next_hop,
+                                            const size_t mtu = NetworkInterface::DEFAULT_MTU);
     //! Attempts to read and parse an Ethernet frame containing an IPv4 datagram that contains a TCP segment
     std::optional<TCPSegment> read();
 
@@ -66,6 +68,11 @@ class TCPOverIPv4OverEthernetAdapter : public TCPOverIPv4Adapter {
     //! Called periodically when time elapses
     void tick(const size_t ms_since_last_tick);
 
+    //! Largest TCP payload that fits in one frame, given both the configured and the interface's MTU
+    uint16_t max_segment_size() const {
+        return std::min<size_t>(config().mtu, _interface.mtu()) - IPv4Header::LENGTH - TCPHeader::LENGTH;
+    }
+
     //! Access the underlying raw Ethernet connection
     operator TapFD &() { return _tap; }
 
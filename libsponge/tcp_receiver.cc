@@ -33,7 +33,7 @@ void TCPReceiver::segment_received(const TCPSegment &seg) {
     if (seg_len == 0 && !header.syn && !header.fin) {
         return;
     }
-    _reassembler.push_substring(seg.payload().copy(), stream_index, header.fin);
+    _reassembler.push_substring(seg.payload(), stream_index, header.fin);
 }
 
 optional<WrappingInt32> TCPReceiver::ackno() const {
@@ -51,6 +51,18 @@ optional<WrappingInt32> TCPReceiver::ackno() const {
     return wrap(abs_ackno, _isn.value());
 }
 
+vector<TCPHeader::SackBlock> TCPReceiver::sack_blocks(const size_t max_blocks) const {
+    vector<TCPHeader::SackBlock> blocks;
+    if (!_syn_received) {
+        return blocks;
+    }
+    // 流中下标 i 对应的绝对序号是 i + 1 (SYN 占用了序号 0)
+    for (const auto &range : _reassembler.recent_unassembled_ranges(max_blocks)) {
+        blocks.push_back({wrap(range.begin + 1, _isn.value()), wrap(range.end + 1, _isn.value())});
+    }
+    return blocks;
+}
+
 size_t TCPReceiver::window_size() const {
     // 窗口大小 = 总容量 - 已交付 ByteStream 但未被读取的字节数。
     size_t data_in_buffer = stream_out().buffer_size();
@@ -7,6 +7,7 @@
 #include "wrapping_integers.hh"
 
 #include <optional>
+#include <vector>
 
 //! \brief The "receiver" part of a TCP implementation.
 
@@ -28,7 +29,9 @@ class TCPReceiver {
     //!
     //! \param capacity the maximum number of bytes that the receiver will
     //!                 store in its buffers at any give time.
-    TCPReceiver(const size_t capacity) : _reassembler(capacity), _capacity(capacity) {}
+    //! \param storage how the reassembled byte stream holds its bytes
+    TCPReceiver(const size_t capacity, const ByteStream::Storage storage = ByteStream::Storage::Ring)
+        : _reassembler(capacity, storage), _capacity(capacity) {}
 
     //! \name Accessors to provide feedback to the remote TCPSender
     //!@{
@@ -53,9 +56,29 @@ class TCPReceiver {
     size_t window_size() const;
     //!@}
 
+    //! \brief the maximum number of bytes the receiver will store
+    size_t capacity() const { return _capacity; }
+
+    //! \brief change the maximum number of bytes the receiver will store, and so the window it advertises
+    //! \note the caller must not shrink the capacity below the bytes stored plus the window last advertised:
+    //! that would retract the right edge of the window offered to the peer, and data the peer is entitled to
+    //! send would be dropped
+    //! \throws std::invalid_argument if the new capacity cannot hold the bytes already stored
+    void set_capacity(const size_t capacity) {
+        _reassembler.set_capacity(capacity);
+        _capacity = capacity;
+    }
+
     //! \brief number of bytes stored but not yet reassembled
     size_t unassembled_bytes() const { return _reassembler.unassembled_bytes(); }
 
+    //! \brief [SACK](\ref rfc::rfc2018) blocks for the data that has arrived out of order, most recent first
+    //! \returns an empty vector before the SYN has arrived or when nothing is waiting to be reassembled
+    std::vector<TCPHeader::SackBlock> sack_blocks(const size_t max_blocks = TCPHeader::MAX_SACK_BLOCKS) const;
+
+    //! \brief the reassembler, for its statistics and unassembled ranges
+    const StreamReassembler &reassembler() const { return _reassembler; }
+
     //! \brief handle an inbound segment
     void segment_received(const TCPSegment &seg);
 
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 #include <random>
 
 using namespace std;
@@ -11,13 +12,137 @@ using namespace std;
 //! \param[in] capacity the capacity of the outgoing byte stream
 //! \param[in] retx_timeout the initial amount of time to wait before retransmitting the oldest outstanding segment
 //! \param[in] fixed_isn the Initial Sequence Number to use, if set (otherwise uses a random ISN)
-TCPSender::TCPSender(const size_t capacity, const uint16_t retx_timeout, const optional<WrappingInt32> fixed_isn)
+//! \param[in] storage how the outgoing byte stream holds its bytes
+TCPSender::TCPSender(const size_t capacity,
+                     const uint16_t retx_timeout,
+                     const optional<WrappingInt32> fixed_isn,
+                     const ByteStream::Storage storage)
     : _isn(fixed_isn.value_or(WrappingInt32{random_device()()}))
     , _initial_retransmission_timeout{retx_timeout}
-    , _stream(capacity)
+    , _stream(capacity, storage)
     , _rto(retx_timeout) // 确保 RTO 被初始化
+    , _rtt(retx_timeout, TCPConfig::MIN_RTO_DFLT, TCPConfig::MAX_RTO_DFLT)
     {}
 
+//! \param[in] cfg the connection's configuration
+TCPSender::TCPSender(const TCPConfig &cfg)
+    : TCPSender(cfg.send_capacity, cfg.rt_timeout, cfg.fixed_isn, cfg.send_storage()) {
+    _max_mss = cfg.mss;
+    _congestion_control_algorithm = cfg.congestion_control;
+    update_mss();
+    _rtt = RTTEstimator(cfg.rt_timeout, cfg.min_rto, cfg.max_rto);
+    _adaptive_rto = cfg.adaptive_rto;
+    _fast_retransmit = cfg.fast_retransmit;
+    _pacing = cfg.pacing;
+    _rack_tlp = cfg.rack_tlp;
+    // 开始按速率发送时，桶里已有两个段的令牌
+    _pacing_credit = static_cast<int64_t>(2 * _mss * 1000);
+}
+
+//! \param[in] peer_mss is the MSS option from the peer's SYN
+void TCPSender::set_peer_mss(const uint16_t peer_mss) {
+    _peer_mss = peer_mss;
+    update_mss();
+}
+
+//! \param[in] bytes is the length of the options every segment carries
+void TCPSender::set_option_overhead(const size_t bytes) {
+    _option_overhead = bytes;
+    update_mss();
+}
+
+void TCPSender::update_mss() {
+    const size_t mss = min(_max_mss, _peer_mss);
+    // 负载为 0 没有意义，至少按 1 字节处理
+    _mss = max<size_t>(mss - min(mss, _option_overhead), 1);
+    // 拥塞窗口以 MSS 为单位，按新的 MSS 重新开始 (此时只有 SYN 在途)
+    _congestion_control = CongestionControl::make(_congestion_control_algorithm, _mss);
+}
+
+size_t TCPSender::base_rto() const { return _adaptive_rto ? _rtt.rto() : _initial_retransmission_timeout; }
+
+uint64_t TCPSender::send_window() const {
+    // 零窗口时按 1 字节处理，用于发送窗口探测
+    const uint64_t receiver_window = _window_size == 0 ? 1 : _window_size;
+    if (!_congestion_control) {
+        return receiver_window;
+    }
+    if (_in_recovery && _sack_recovery) {
+        // PRR：在途数据之外只允许再发送 _prr_sndcnt 个字节
+        return min(receiver_window, _bytes_in_flight + _prr_sndcnt);
+    }
+    return min(receiver_window, _congestion_control->cwnd() + _recovery_inflation);
+}
+
+void TCPSender::on_segment_sent(const uint64_t end) {
+    if (_in_recovery && _sack_recovery) {
+        const uint64_t len = end - _next_seqno;
+        _prr_out += len;
+        _prr_sndcnt -= min(_prr_sndcnt, len);
+    }
+    if (!_timed_seqno.has_value()) {
+        _timed_seqno = end;
+        _timed_sent_ms = _now_ms;
+    }
+}
+
+uint64_t TCPSender::pacing_rate() const {
+    if (!_pacing) {
+        return 0;
+    }
+    if (_congestion_control && _congestion_control->pacing_rate() > 0) {
+        return _congestion_control->pacing_rate();
+    }
+    // 没有 RTT 样本之前无法计算速率，不限速
+    if (!_rtt.srtt().has_value()) {
+        return 0;
+    }
+    const bool slow_start = _congestion_control && _congestion_control->in_slow_start();
+    const double gain = slow_start ? PACING_GAIN_SLOW_START : PACING_GAIN_AVOIDANCE;
+    const double srtt_ms = max(_rtt.srtt().value(), 1.0);
+    return static_cast<uint64_t>(gain * static_cast<double>(send_window()) * 1000 / srtt_ms);
+}
+
+optional<size_t> TCPSender::next_send_delay() const {
+    const uint64_t rate = pacing_rate();
+    if (!_pacing_blocked || rate == 0) {
+        return {};
+    }
+    // 令牌余额变为正数所需的时间
+    const uint64_t deficit = _pacing_credit < 0 ? static_cast<uint64_t>(-_pacing_credit) : 0;
+    return deficit / rate + 1;
+}
+
+optional<size_t> TCPSender::next_timeout() const {
+    optional<size_t> timeout = next_send_delay();
+    if (!_outstanding.empty()) {
+        const size_t rto_remaining = _rto > _timer_ms ? _rto - _timer_ms : 0;
+        timeout = min(timeout.value_or(rto_remaining), rto_remaining);
+        // RACK 的乱序计时器和尾部丢失探测计时器
+        for (const auto &deadline : {_rack_deadline_ms, _tlp_deadline_ms}) {
+            if (deadline.has_value()) {
+                const size_t remaining = deadline.value() > _now_ms ? deadline.value() - _now_ms : 0;
+                timeout = min(timeout.value(), remaining);
+            }
+        }
+    }
+    return timeout;
+}
+
+void TCPSender::refill_pacing_budget(const size_t ms_since_last_tick) {
+    const uint64_t rate = pacing_rate();
+    if (rate == 0) {
+        return;
+    }
+    // 桶里最多攒下 PACING_MAX_BURST_MS 的令牌 (至少两个段)：空闲之后、或者很久才 tick 一次时，不会一下子发出一大串
+    const int64_t refill = static_cast<int64_t>(rate * ms_since_last_tick);
+    const int64_t depth = static_cast<int64_t>(max(rate * PACING_MAX_BURST_MS, 2 * _mss * 1000));
+    _pacing_credit = min(_pacing_credit + refill, depth);
+    if (_pacing_blocked) {
+        fill_window();
+    }
+}
+
 uint64_t TCPSender::bytes_in_flight() const { 
     return _bytes_in_flight; 
 }
@@ -31,7 +156,8 @@ void TCPSender::fill_window() {
         return;
     }
 
-    uint64_t current_window = _window_size == 0 ? 1 : _window_size;
+    uint64_t current_window = send_window();
+    _pacing_blocked = false;
 
     if (!_syn_sent) {
         if (current_window - _bytes_in_flight >= 1) {
@@ -40,27 +166,35 @@ void TCPSender::fill_window() {
             seg.header().seqno = next_seqno();
 
             _segments_out.push(seg);
-            _outstanding_segments.push_back(seg);
+            _outstanding.push_back({_next_seqno, {}, true, false, false, false, _now_ms});
+            on_segment_sent(_next_seqno + 1);
 
             _syn_sent = true;
             _next_seqno += 1;
             _bytes_in_flight += 1;
 
-            if (_outstanding_segments.size() == 1) {
+            if (_outstanding.size() == 1) {
                 _timer_ms = 0;
-                _rto = _initial_retransmission_timeout;
+                _rto = base_rto();
             }
         }
     }
 
     while (true) {
-        current_window = _window_size == 0 ? 1 : _window_size;
+        current_window = send_window();
         uint64_t window_remaining = current_window > _bytes_in_flight ? current_window - _bytes_in_flight : 0;
 
         if (window_remaining == 0) {
             break;
         }
 
+        // 令牌不足时暂停发送新数据，等 tick 补充
+        const bool has_data = _stream.buffer_size() > 0 || (_stream.eof() && !_fin_sent);
+        if (has_data && _pacing_credit <= 0 && pacing_rate() > 0) {
+            _pacing_blocked = true;
+            break;
+        }
+
         uint64_t max_payload_for_window = window_remaining;
 
         TCPSegment seg;
@@ -69,11 +203,12 @@ void TCPSender::fill_window() {
         size_t max_payload_len = min({
             max_payload_for_window,
             static_cast<uint64_t>(_stream.buffer_size()),
-            static_cast<uint64_t>(TCPConfig::MAX_PAYLOAD_SIZE)
+            static_cast<uint64_t>(_mss)
         });
 
         if (max_payload_len > 0) {
-            seg.payload() = _stream.read(max_payload_len);
+            // 链式存储时负载直接是发送缓冲区中字节的切片，不复制；在途记录持有它直到被确认
+            seg.payload() = _stream.read_buffer(max_payload_len);
         }
 
         bool fin_possible = _stream.eof() && !_fin_sent;
@@ -92,16 +227,23 @@ void TCPSender::fill_window() {
         }
 
         _segments_out.push(seg);
-        _outstanding_segments.push_back(seg);
+        _outstanding.push_back({_next_seqno, seg.payload(), false, seg.header().fin, false, false, _now_ms});
+        on_segment_sent(_next_seqno + len_in_seq_space);
 
         _next_seqno += len_in_seq_space;
         _bytes_in_flight += len_in_seq_space;
+        if (pacing_rate() > 0) {
+            _pacing_credit -= static_cast<int64_t>(len_in_seq_space * 1000);
+        }
 
-        if (_outstanding_segments.size() == 1) {
+        if (_outstanding.size() == 1) {
             _timer_ms = 0;
-            _rto = _initial_retransmission_timeout;
+            _rto = base_rto();
         }
 
+        // 发出新数据时重新安排尾部丢失探测
+        schedule_tail_loss_probe();
+
         if (_fin_sent) {
             break;
         }
@@ -112,56 +254,406 @@ void TCPSender::fill_window() {
 }
 
 void TCPSender::tick(const size_t ms_since_last_tick) {
-    if (_outstanding_segments.empty()) {
-        return; // 没有待确认数据
-    }
+    _now_ms += ms_since_last_tick;
 
-    _timer_ms += ms_since_last_tick;
+    // 没有待确认数据时重传计时器不走
+    if (!_outstanding.empty()) {
+        _timer_ms += ms_since_last_tick;
+    }
 
-    if (_timer_ms >= _rto) {
+    if (!_outstanding.empty() && _timer_ms >= _rto) {
         _timer_ms = 0;
 
-        TCPSegment oldest_segment = _outstanding_segments.front();
-        _segments_out.push(oldest_segment); // 重新放入发送队列
+        // 重传最早的在途段；Karn 算法：重传后无法区分 ACK 对应哪一次发送，放弃当前的计时段
+        retransmit(_outstanding.front());
+
+        // 超时后放弃快速恢复；在已发送的数据被确认之前不再因重复 ACK 进入快速恢复 (RFC 6582)
+        _in_recovery = false;
+        _recovery_inflation = 0;
+        _recover = _next_seqno;
+        _dup_acks = 0;
+        _sack_recovery = false;
+        for (auto &record : _outstanding) {
+            record.lost = false;
+            record.retransmitted = false;
+        }
+        _rack_deadline_ms.reset();
+        _tlp_deadline_ms.reset();
+        _tlp_end.reset();
 
         if (_window_size > 0) {
-            _rto *= 2;
+            _rto = _adaptive_rto ? _rtt.backed_off(_rto) : _rto * 2;
+            // 零窗口探测超时不代表拥塞
+            if (_congestion_control) {
+                _congestion_control->on_retransmission_timeout(_bytes_in_flight, _now_ms);
+            }
         }
 
         _consecutive_retransmissions++;
     }
+
+    if (_rack_tlp && !_outstanding.empty()) {
+        // 乱序计时器到期：等待乱序的时间已过，更早发出的段仍未送达
+        if (_rack_deadline_ms.has_value() && _now_ms >= _rack_deadline_ms.value()) {
+            _rack_deadline_ms.reset();
+            if (_in_recovery && _sack_recovery) {
+                sack_recovery_step(0);
+            } else if (!_in_recovery) {
+                mark_lost_segments();
+                if (has_lost_segments()) {
+                    enter_recovery(0);
+                }
+            }
+        }
+        if (_tlp_deadline_ms.has_value() && _now_ms >= _tlp_deadline_ms.value() && !_in_recovery) {
+            send_tail_loss_probe();
+        }
+    }
+
+    refill_pacing_budget(ms_since_last_tick);
 }
 
-void TCPSender::ack_received(const WrappingInt32 ackno, const uint16_t window_size) {
+void TCPSender::ack_received(const WrappingInt32 ackno,
+                             const uint64_t window_size,
+                             const vector<TCPHeader::SackBlock> &sack_blocks,
+                             const optional<uint32_t> timestamp_echo,
+                             const bool pure_ack) {
+    const uint64_t previous_window_size = _window_size;
+    const uint64_t previous_bytes_in_flight = _bytes_in_flight;
     _window_size = window_size;
     uint64_t ack_abs_seqno = unwrap(ackno, _isn, _next_seqno);
     if (ack_abs_seqno > _next_seqno) {
         return; 
     }
+    // 对端新收到的字节数 (RFC 6937 的 DeliveredData)：累计确认的推进量加上 SACK 记分板的变化量
+    const uint64_t sacked_before = _sacked.size();
+    uint64_t bytes_acked = 0;
     if (ack_abs_seqno > _ack_abs_seqno) {
-        bool new_bytes_acked = true;
         uint64_t old_ack_abs_seqno = _ack_abs_seqno;
         _ack_abs_seqno = ack_abs_seqno;
-        auto it = _outstanding_segments.begin();
-        while (it != _outstanding_segments.end()) {
-            const TCPSegment& seg = *it;
-            uint64_t seg_start_abs = unwrap(seg.header().seqno, _isn, old_ack_abs_seqno);
-            uint64_t seg_end_abs = seg_start_abs + seg.length_in_sequence_space();
-            if (ack_abs_seqno >= seg_end_abs) {
-                size_t len = seg.length_in_sequence_space();
-                _bytes_in_flight -= len;
-                it = _outstanding_segments.erase(it);
+        // 记录按序号排列，完全被确认的段都在队首
+        while (!_outstanding.empty() && _outstanding.front().end() <= ack_abs_seqno) {
+            rack_on_delivered(_outstanding.front());
+            _bytes_in_flight -= _outstanding.front().length();
+            _outstanding.pop_front();
+        }
+        _sacked.remove_prefix(ack_abs_seqno);
+        // 计时段被确认，得到一个 RTT 样本
+        optional<uint64_t> rtt_ms;
+        const int32_t echo_age = static_cast<int32_t>(timestamp() - timestamp_echo.value_or(0));
+        if (timestamp_echo.has_value() && echo_age >= 0) {
+            // 时间戳回显 (RFC 7323)：每个确认新数据的 ACK 都是一个样本，重传的段也不会混淆；
+            // 一个 RTT 内预计有 在途字节 / (2 * MSS) 个样本，据此降低每个样本的权重
+            rtt_ms = max<uint64_t>(echo_age, 1);
+            const uint64_t flight = _bytes_in_flight + (ack_abs_seqno - old_ack_abs_seqno);
+            _rtt.sample(rtt_ms.value(), (flight + 2 * _mss - 1) / (2 * _mss));
+            _timed_seqno.reset();
+        } else if (_timed_seqno.has_value() && ack_abs_seqno >= _timed_seqno.value()) {
+            // 时钟精度只有 tick 的间隔，不足 1 ms 的样本按 1 ms 计
+            rtt_ms = max<uint64_t>(_now_ms - _timed_sent_ms, 1);
+            _timed_seqno.reset();
+            _rtt.sample(rtt_ms.value());
+        }
+
+        _rto = base_rto();
+        _consecutive_retransmissions = 0;
+        _timer_ms = 0;
+        bytes_acked = ack_abs_seqno - old_ack_abs_seqno;
+
+        // 快速恢复期间 (包括结束恢复的这个 ACK) 拥塞窗口保持不变
+        if (_congestion_control && !_in_recovery) {
+            _congestion_control->on_ack({bytes_acked, _bytes_in_flight, _now_ms, rtt_ms});
+        }
+    }
+
+    const uint64_t sacked_unacked = _sacked.size();
+    record_sack_blocks(sack_blocks);
+    const bool newly_sacked = _sacked.size() > sacked_unacked;
+    if (_rack_tlp && newly_sacked) {
+        for (const auto &record : _outstanding) {
+            if (_sacked.covers(record.seqno, record.end())) {
+                rack_on_delivered(record);
+            }
+        }
+    }
+    // 之前被 SACK 的字节被累计确认时，记分板会缩小，这部分不能重复计入
+    const uint64_t reached = bytes_acked + _sacked.size();
+    const uint64_t delivered = reached > sacked_before ? reached - sacked_before : 0;
+
+    if (bytes_acked > 0) {
+        _dup_acks = 0;
+        if (_in_recovery) {
+            if (ack_abs_seqno >= _recover) {
+                // 完整确认：进入恢复时发出的数据都已确认，退出快速恢复
+                _in_recovery = false;
+                _sack_recovery = false;
+                _recovery_inflation = 0;
+            } else if (_sack_recovery) {
+                sack_recovery_step(delivered);
             } else {
-                break;
+                // 部分确认 (NewReno)：新的最早在途段也丢失了，立即重传；
+                // 窗口膨胀减去被确认的部分，再加回重传的这一个段
+                _recovery_inflation -= min(_recovery_inflation, bytes_acked);
+                _recovery_inflation += _mss;
+                retransmit_first_outstanding();
             }
         }
-        if (new_bytes_acked) {
-            _rto = _initial_retransmission_timeout;
-            _consecutive_retransmissions = 0;
-            _timer_ms = 0;
+    } else if (_fast_retransmit && pure_ack && ack_abs_seqno == _ack_abs_seqno && _bytes_in_flight > 0 &&
+               (window_size == previous_window_size || newly_sacked)) {
+        // 重复 ACK (RFC 5681)：不带数据、SYN、FIN 的段，确认号与窗口都没有变化 (或者带来了新的 SACK 信息)，
+        // 但仍有数据在途
+        _dup_acks++;
+        if (_in_recovery) {
+            if (_sack_recovery) {
+                sack_recovery_step(delivered);
+            } else {
+                // 又有一个段离开了网络，可以再发送一个新段
+                _recovery_inflation += _mss;
+            }
+        } else if (ack_abs_seqno > _recover) {
+            // 重复 ACK 达到阈值，或者记分板已经能断定最早的在途段丢失 (RFC 6675)
+            mark_lost_segments();
+            const bool front_lost = !_outstanding.empty() && _outstanding.front().lost;
+            if (_dup_acks >= DUP_ACK_THRESHOLD || front_lost) {
+                enter_recovery(delivered);
+            }
         }
-    } 
+    }
+
+    if (_rack_tlp) {
+        // 探测段之前的数据全部被确认：只丢了尾部 (或者什么也没丢)。没有 DSACK 无法区分两者，
+        // 按丢失处理，做一次拥塞响应 (RFC 8985 7.4)
+        if (_tlp_end.has_value() && ack_abs_seqno >= _tlp_end.value()) {
+            _tlp_end.reset();
+            if (_congestion_control && !_in_recovery) {
+                _congestion_control->on_congestion_event(previous_bytes_in_flight, _now_ms);
+            }
+        }
+        // RACK 对每个 ACK 都检查：任何段被送达，都可能说明更早发出的段已经丢失
+        if (!_in_recovery && !_outstanding.empty() && ack_abs_seqno > _recover) {
+            mark_lost_segments();
+            if (has_lost_segments()) {
+                enter_recovery(delivered);
+            }
+        }
+    }
     fill_window();
+    if (bytes_acked > 0) {
+        schedule_tail_loss_probe();
+    }
+}
+
+void TCPSender::rack_on_delivered(const OutstandingSegment &record) {
+    const uint64_t rtt = _now_ms - record.sent_ms;
+    // 重传过的段，ACK 可能是对之前那次发送的确认；比最小 RTT 还短的样本不可信
+    const optional<uint64_t> min_rtt = _rtt.min_rtt();
+    if (record.retransmitted && min_rtt.has_value() && rtt < min_rtt.value()) {
+        return;
+    }
+    const bool later = !_rack_xmit_ms.has_value() || record.sent_ms > _rack_xmit_ms.value() ||
+                       (record.sent_ms == _rack_xmit_ms.value() && record.end() > _rack_end);
+    if (later) {
+        _rack_xmit_ms = record.sent_ms;
+        _rack_end = record.end();
+        _rack_rtt = rtt;
+    }
+}
+
+bool TCPSender::rack_sent_before_delivered(const OutstandingSegment &record) const {
+    if (!_rack_xmit_ms.has_value()) {
+        return false;
+    }
+    // 时钟精度有限，同一时刻发出的段按序号区分先后
+    return record.sent_ms < _rack_xmit_ms.value() ||
+           (record.sent_ms == _rack_xmit_ms.value() && record.end() < _rack_end);
+}
+
+uint64_t TCPSender::rack_reordering_window() const {
+    const optional<uint64_t> min_rtt = _rtt.min_rtt();
+    if (!min_rtt.has_value()) {
+        return 0;
+    }
+    // 最小 RTT 的四分之一，但不超过 SRTT
+    const uint64_t srtt = static_cast<uint64_t>(_rtt.srtt().value_or(0));
+    return min(min_rtt.value() / 4, srtt);
+}
+
+bool TCPSender::has_lost_segments() const {
+    return any_of(_outstanding.begin(), _outstanding.end(), [](const auto &record) { return record.lost; });
+}
+
+void TCPSender::schedule_tail_loss_probe() {
+    _tlp_deadline_ms.reset();
+    // 恢复期间、或者已有探测段在途时不再探测；没有 RTT 样本时只能等 RTO
+    if (!_rack_tlp || _outstanding.empty() || _in_recovery || _tlp_end.has_value() || !_rtt.srtt().has_value()) {
+        return;
+    }
+    // PTO = 2 * SRTT；只有一个段在途时，还要等对端的延迟确认
+    uint64_t pto = static_cast<uint64_t>(2 * _rtt.srtt().value()) + 1;
+    if (_bytes_in_flight <= _mss) {
+        pto += WORST_CASE_DELAYED_ACK_MS;
+    }
+    // RTO 会先到期时不需要探测
+    const uint64_t rto_remaining = _rto > _timer_ms ? _rto - _timer_ms : 0;
+    if (pto >= rto_remaining) {
+        return;
+    }
+    _tlp_deadline_ms = _now_ms + pto;
+}
+
+void TCPSender::send_tail_loss_probe() {
+    _tlp_deadline_ms.reset();
+    // 重传最后一个在途段：对它的 ACK (带着 SACK) 能让 RACK 发现前面的丢失，而不必等 RTO
+    OutstandingSegment &last = _outstanding.back();
+    retransmit(last);
+    _tlp_end = last.end();
+    _tail_loss_probes++;
+    // RTO 从探测段发出时重新计时
+    _timer_ms = 0;
+}
+
+void TCPSender::record_sack_blocks(const vector<TCPHeader::SackBlock> &sack_blocks) {
+    for (const auto &block : sack_blocks) {
+        const uint64_t left = unwrap(block.left, _isn, _ack_abs_seqno);
+        const uint64_t right = unwrap(block.right, _isn, _ack_abs_seqno);
+        // 忽略不合理的块：顺序颠倒、覆盖了尚未发送的序号
+        if (left >= right || right > _next_seqno) {
+            continue;
+        }
+        _sacked.insert(max(left, _ack_abs_seqno), right);
+    }
+}
+
+uint64_t TCPSender::mark_lost_segments() {
+    _rack_deadline_ms.reset();
+    // 从最新的段往回扫描，统计每个段之上有多少被 SACK 的段和字节
+    uint64_t sacked_segments_above = 0;
+    uint64_t sacked_bytes_above = 0;
+    uint64_t pipe = 0;
+    for (auto it = _outstanding.rbegin(); it != _outstanding.rend(); ++it) {
+        const uint64_t len = it->length();
+        if (_sacked.covers(it->seqno, it->end())) {
+            sacked_segments_above++;
+            sacked_bytes_above += len;
+            it->lost = false;
+            continue;
+        }
+        // IsLost (RFC 6675)：之上至少有 DupThresh 个段或 (DupThresh - 1) * SMSS 以上的字节被 SACK；
+        // 恢复期间最早的空洞只要之上有数据被 SACK 就视为丢失
+        const bool lost = sacked_segments_above >= DUP_ACK_THRESHOLD ||
+                          sacked_bytes_above > (DUP_ACK_THRESHOLD - 1) * _mss ||
+                          (it + 1 == _outstanding.rend() && _in_recovery && sacked_segments_above > 0);
+        // RACK (RFC 8985)：比某个已送达的段更早发出，而且过了 RTT 加乱序窗口仍未送达；
+        // 重传的段也按最近一次发送的时间判断，所以丢失的重传也能被发现
+        bool rack_lost = false;
+        if (_rack_tlp && rack_sent_before_delivered(*it)) {
+            const uint64_t deadline = it->sent_ms + _rack_rtt + rack_reordering_window();
+            rack_lost = _now_ms >= deadline;
+            if (!rack_lost) {
+                _rack_deadline_ms = min(_rack_deadline_ms.value_or(deadline), deadline);
+            }
+        }
+        it->lost = (lost && !it->retransmitted) || rack_lost;
+        // 未丢失的原始段、以及没有再次丢失的重传段都还在网络中
+        pipe += (lost || rack_lost ? 0 : len) + (it->retransmitted && !rack_lost ? len : 0);
+    }
+    return pipe;
+}
+
+uint64_t TCPSender::retransmit_lost_segments(const uint64_t budget) {
+    uint64_t sent = 0;
+    for (auto it = _outstanding.begin(); it != _outstanding.end() && sent < budget; ++it) {
+        if (!it->lost) {
+            continue;
+        }
+        retransmit(*it);
+        _sack_retransmits++;
+        sent += it->length();
+    }
+    return sent;
+}
+
+void TCPSender::enter_recovery(const uint64_t delivered) {
+    _in_recovery = true;
+    _recover = _next_seqno;
+    if (_congestion_control) {
+        _congestion_control->on_congestion_event(_bytes_in_flight, _now_ms);
+    }
+    _fast_retransmits++;
+    // 恢复本身就是拥塞响应，在途的尾部探测不再单独处理
+    _tlp_deadline_ms.reset();
+    _tlp_end.reset();
+
+    // 对端没有发来过 SACK 信息时退回 NewReno
+    _sack_recovery = !_sacked.empty();
+    if (!_sack_recovery) {
+        _recovery_inflation = DUP_ACK_THRESHOLD * _mss;
+        retransmit_first_outstanding();
+        return;
+    }
+
+    _recover_fs = _bytes_in_flight;
+    _prr_delivered = 0;
+    _prr_out = 0;
+    for (auto &record : _outstanding) {
+        record.retransmitted = false;
+    }
+    // 最早的在途段一定已经丢失，不受 PRR 限制，立即重传
+    retransmit_first_outstanding();
+    _prr_out += _outstanding.front().length();
+    sack_recovery_step(delivered);
+}
+
+void TCPSender::sack_recovery_step(const uint64_t delivered) {
+    const uint64_t pipe = mark_lost_segments();
+    _prr_delivered += delivered;
+
+    if (!_congestion_control) {
+        // 没有拥塞窗口可以收缩，所有丢失的段立即重传
+        retransmit_lost_segments(numeric_limits<uint64_t>::max());
+        return;
+    }
+
+    // RFC 6937：在途数据高于 ssthresh 时按比例发送；低于时用 PRR-SSRB 慢启动回到 ssthresh
+    const uint64_t ssthresh = _congestion_control->cwnd();
+    uint64_t sndcnt = 0;
+    if (pipe > ssthresh) {
+        const uint64_t recover_fs = max<uint64_t>(_recover_fs, 1);
+        const uint64_t allowed = (_prr_delivered * ssthresh + recover_fs - 1) / recover_fs;
+        sndcnt = allowed > _prr_out ? allowed - _prr_out : 0;
+    } else {
+        const uint64_t unsent = _prr_delivered > _prr_out ? _prr_delivered - _prr_out : 0;
+        const uint64_t limit = max(unsent, delivered) + _mss;
+        sndcnt = min(ssthresh - pipe, limit);
+    }
+    _prr_sndcnt = sndcnt;
+
+    // 先重传丢失的段，剩下的额度留给 fill_window 发送新数据
+    const uint64_t resent = retransmit_lost_segments(_prr_sndcnt);
+    _prr_out += resent;
+    _prr_sndcnt -= min(_prr_sndcnt, resent);
+}
+
+void TCPSender::retransmit(OutstandingSegment &record) {
+    TCPSegment seg;
+    seg.header().seqno = wrap(record.seqno, _isn);
+    seg.header().syn = record.syn;
+    seg.header().fin = record.fin;
+    seg.payload() = record.payload;
+    _segments_out.push(seg);
+
+    record.lost = false;
+    record.retransmitted = true;
+    record.sent_ms = _now_ms;
+    // Karn 算法
+    _timed_seqno.reset();
+}
+
+void TCPSender::retransmit_first_outstanding() {
+    if (_outstanding.empty()) {
+        return;
+    }
+    retransmit(_outstanding.front());
 }
 
 void TCPSender::send_empty_segment() {
@@ -2,13 +2,20 @@
 #define SPONGE_LIBSPONGE_TCP_SENDER_HH
 
 #include "byte_stream.hh"
+#include "congestion_control.hh"
+#include "interval_set.hh"
+#include "rtt_estimator.hh"
 #include "tcp_config.hh"
 #include "tcp_segment.hh"
 #include "wrapping_integers.hh"
 
 #include <functional>
+#include <deque>
+#include <memory>
+#include <optional>
 #include <queue>
-#include <list>
+#include <vector>
+
 //! \brief The "sender" part of a TCP implementation.
 
 //! Accepts a ByteStream, divides it up into segments and sends the
@@ -37,7 +44,7 @@ class TCPSender {
     uint64_t _bytes_in_flight{0};         // 在途（已发送但未确认）的序列号总数
 
     // 窗口和控制标志
-    uint16_t _window_size{1};             // 接收方通告的窗口大小 (初始设为 1 用于 SYN)
+    uint64_t _window_size{1};             // 接收方通告的窗口大小，已按窗口扩大因子换算 (初始设为 1 用于 SYN)
     bool _syn_sent{false};                // 标记是否已发送 SYN
     bool _fin_sent{false};                // 标记是否已发送 FIN
 
@@ -46,14 +53,145 @@ class TCPSender {
     size_t _timer_ms{0};                  // 计时器计数
     unsigned int _consecutive_retransmissions{0}; // 连续重传次数
 
-    // 存储在途段以便追踪和重传
-    std::list<TCPSegment> _outstanding_segments{};
+    // 在途段记录：按绝对序号排列，只保存序号、标志和负载。
+    // 负载与发出的段共享同一份字节 (Buffer 引用计数)，重传时据此重新构造段，不再保留段对象的副本
+    struct OutstandingSegment {
+        uint64_t seqno;      // 段占用的第一个绝对序号
+        Buffer payload;      // 段负载
+        bool syn;
+        bool fin;
+        bool lost;           // 记分板判定丢失、等待重传
+        bool retransmitted;  // 本次恢复中已经重传过
+        uint64_t sent_ms;    // 最近一次 (重新) 发出的时间，RACK 据此按时间判断丢失
+
+        uint64_t length() const { return payload.size() + (syn ? 1 : 0) + (fin ? 1 : 0); }
+        uint64_t end() const { return seqno + length(); }
+    };
+    std::deque<OutstandingSegment> _outstanding{};
+
+    // 每个段的最大负载：不超过本端配置的 _max_mss，以及对端 SYN 中通告的 MSS，
+    // 再减去每个段都带的选项 (RFC 6691：MSS 不包括 TCP 选项)
+    size_t _max_mss{TCPConfig::MAX_PAYLOAD_SIZE};
+    size_t _peer_mss{TCPConfig::MAX_PAYLOAD_SIZE};
+    size_t _option_overhead{0};
+    size_t _mss{TCPConfig::MAX_PAYLOAD_SIZE};
+
+    // 拥塞控制 (为空表示只受接收方窗口限制)
+    CongestionControl::Algorithm _congestion_control_algorithm{CongestionControl::Algorithm::None};
+    std::unique_ptr<CongestionControl> _congestion_control{};
+
+    // 发送方时钟 (由 tick 推进) 以及用于测量 RTT 的计时段：
+    // 每个 RTT 只对一个段计时，被重传过的段不计时 (Karn 算法)
+    uint64_t _now_ms{0};
+    std::optional<uint64_t> _timed_seqno{};  // 计时段的结束绝对序号
+    uint64_t _timed_sent_ms{0};              // 计时段的发送时间
+
+    // RTT 估计 (RFC 6298)；只有开启 adaptive_rto 时才用它计算 RTO
+    RTTEstimator _rtt;
+    bool _adaptive_rto{false};
+
+    // 快速重传与 NewReno 快速恢复 (RFC 5681, RFC 6582)
+    static constexpr unsigned DUP_ACK_THRESHOLD = 3;
+    bool _fast_retransmit{false};
+    unsigned _dup_acks{0};            // 连续收到的重复 ACK 数
+    bool _in_recovery{false};         // 是否处于快速恢复
+    uint64_t _recover{0};             // 进入恢复时的 _next_seqno，确认到这里才算恢复完成
+    uint64_t _recovery_inflation{0};  // 快速恢复期间拥塞窗口的临时膨胀量
+    uint64_t _fast_retransmits{0};    // 快速重传的次数
+
+    // SACK 记分板 (RFC 6675)：对端通过 SACK 块确认过的绝对序号范围；丢失与重传状态记在在途段记录上
+    IntervalSet _sacked{};
+    bool _sack_recovery{false};       // 本次快速恢复是否由记分板驱动
+    uint64_t _sack_retransmits{0};    // 按记分板选择性重传的段数
+
+    // 比例降速 (PRR, RFC 6937)：恢复期间按 ACK 送达的数据量成比例地发送
+    uint64_t _recover_fs{0};     // 进入恢复时的在途字节数
+    uint64_t _prr_delivered{0};  // 恢复期间对端收到的字节数
+    uint64_t _prr_out{0};        // 恢复期间发出的字节数
+    uint64_t _prr_sndcnt{0};     // 当前还允许发送的字节数
+
+    // 发送节奏控制 (pacing)：令牌按速率随 tick 补充，余额耗尽时 fill_window 暂停发送新数据。
+    // 令牌以千分之一字节计，低速率下每个 tick 补充的零头也不会被舍掉；发送可以透支，由之后的 tick 补上
+    static constexpr double PACING_GAIN_SLOW_START = 2.0;  // 慢启动时窗口每个 RTT 翻倍，速率要跟得上
+    static constexpr double PACING_GAIN_AVOIDANCE = 1.2;
+    static constexpr size_t PACING_MAX_BURST_MS = 10;      // 桶里最多攒下这么长时间的令牌
+    bool _pacing{false};
+    int64_t _pacing_credit{0};
+    bool _pacing_blocked{false};  // fill_window 因为令牌不足而停下，还有数据等着发送
+
+    // RACK-TLP (RFC 8985)：按发送时间判断丢失，并在尾部丢失时提前发出探测段
+    static constexpr uint64_t WORST_CASE_DELAYED_ACK_MS = 200;  // 只有一个段在途时，对端可能推迟这么久才确认
+    bool _rack_tlp{false};
+    std::optional<uint64_t> _rack_xmit_ms{};       // 已送达的段中最近发出的那个的发送时间
+    uint64_t _rack_end{0};                         // 以及它的结束序号 (发送时间相同时按序号区分先后)
+    uint64_t _rack_rtt{0};                         // 以及它的 RTT
+    std::optional<uint64_t> _rack_deadline_ms{};   // 乱序计时器：更早发出的段在这时还没送达就算丢失
+    std::optional<uint64_t> _tlp_deadline_ms{};    // 尾部丢失探测计时器 (PTO)
+    std::optional<uint64_t> _tlp_end{};            // 在途探测段的结束序号
+    uint64_t _tail_loss_probes{0};
+
+    //! \brief rebuild the segment for an outstanding record and queue it for sending again
+    void retransmit(OutstandingSegment &record);
+
+    //! \brief resend the oldest outstanding segment
+    void retransmit_first_outstanding();
+
+    //! \brief add the peer's SACK blocks to the scoreboard, ignoring any outside [ackno, next seqno)
+    void record_sack_blocks(const std::vector<TCPHeader::SackBlock> &sack_blocks);
+
+    //! \brief RACK: note that an outstanding record was delivered (cumulatively or selectively acknowledged)
+    void rack_on_delivered(const OutstandingSegment &record);
+
+    //! \brief RACK: was the record sent before the most recently sent segment that was delivered?
+    bool rack_sent_before_delivered(const OutstandingSegment &record) const;
+
+    //! \brief RACK: the reordering window, a quarter of the minimum RTT
+    uint64_t rack_reordering_window() const;
+
+    //! \brief is any outstanding segment marked lost?
+    bool has_lost_segments() const;
+
+    //! \brief arm the tail loss probe timer, if a probe would come before the RTO
+    void schedule_tail_loss_probe();
+
+    //! \brief resend the last outstanding segment, to draw an ACK that reveals a tail loss
+    void send_tail_loss_probe();
+
+    //! \brief mark the outstanding segments the scoreboard (or RACK) shows as lost but not yet retransmitted
+    //! \returns the estimated number of bytes still in the network (RFC 6675's "pipe")
+    uint64_t mark_lost_segments();
+
+    //! \brief resend segments marked lost, oldest first, until `budget` bytes have been sent
+    //! \returns the number of bytes resent
+    uint64_t retransmit_lost_segments(const uint64_t budget);
+
+    //! \brief start fast recovery: reduce the congestion window and resend the oldest outstanding segment
+    void enter_recovery(const uint64_t delivered);
+
+    //! \brief during SACK-based recovery, recompute the PRR sending allowance and resend lost segments
+    void sack_recovery_step(const uint64_t delivered);
+
+    //! \brief recompute the largest payload, and restart congestion control to count in it
+    void update_mss();
+
+    //! \brief the RTO to start the timer with: the estimator's if adaptive, otherwise the initial one
+    size_t base_rto() const;
+
+    //! \brief record a newly sent segment ending at absolute seqno `end`, timing it if nothing is being timed
+    void on_segment_sent(const uint64_t end);
+
+    //! \brief add `ms_since_last_tick` worth of pacing tokens, and send what was waiting for them
+    void refill_pacing_budget(const size_t ms_since_last_tick);
 
   public:
     //! Initialize a TCPSender
     TCPSender(const size_t capacity = TCPConfig::DEFAULT_CAPACITY,
               const uint16_t retx_timeout = TCPConfig::TIMEOUT_DFLT,
-              const std::optional<WrappingInt32> fixed_isn = {});
+              const std::optional<WrappingInt32> fixed_isn = {},
+              const ByteStream::Storage storage = ByteStream::Storage::Ring);
+
+    //! Initialize a TCPSender from a connection's configuration
+    explicit TCPSender(const TCPConfig &cfg);
 
     //! \name "Input" interface for the writer
     //!@{
@@ -64,8 +202,24 @@ class TCPSender {
     //! \name Methods that can cause the TCPSender to send a segment
     //!@{
 
-    //! \brief A new acknowledgment was received
-    void ack_received(const WrappingInt32 ackno, const uint16_t window_size);
+    //! \brief A new acknowledgment was received, possibly with SACK blocks (only if SACK was negotiated)
+    //! and the echo of one of our timestamps (only if timestamps were negotiated)
+    //! \note `window_size` is in bytes, already scaled if window scaling was negotiated
+    //! \note `pure_ack` says the segment carried no data, SYN or FIN; only such a segment can be a duplicate
+    //! ACK ([RFC 5681](\ref rfc::rfc5681) section 2), since a peer sending its own data repeats its ackno
+    //! without having received anything out of order
+    void ack_received(const WrappingInt32 ackno,
+                      const uint64_t window_size,
+                      const std::vector<TCPHeader::SackBlock> &sack_blocks = {},
+                      const std::optional<uint32_t> timestamp_echo = {},
+                      const bool pure_ack = true);
+
+    //! \brief The peer's SYN offered an MSS: send segments no larger than it (or than our own limit)
+    void set_peer_mss(const uint16_t peer_mss);
+
+    //! \brief Every segment from now on carries `bytes` of TCP options (e.g. timestamps): send that much less
+    //! payload, so that full segments still fit the MSS (RFC 6691)
+    void set_option_overhead(const size_t bytes);
 
     //! \brief Generate an empty-payload segment (useful for creating empty ACK segments)
     void send_empty_segment();
@@ -88,6 +242,50 @@ class TCPSender {
     //! \brief Number of consecutive retransmissions that have occurred in a row
     unsigned int consecutive_retransmissions() const;
 
+    //! \brief The RTT estimator, which is fed even when the RTO does not adapt
+    const RTTEstimator &rtt_estimator() const { return _rtt; }
+
+    //! \brief The current retransmission timeout, including any backoff, in milliseconds
+    size_t current_rto() const { return _rto; }
+
+    //! \brief How many sequence numbers may be in flight: the receiver's window, limited by the congestion window
+    uint64_t send_window() const;
+
+    //! \brief Is the sender in fast recovery (after a fast retransmit, until everything sent before it is acked)?
+    bool in_fast_recovery() const { return _in_recovery; }
+
+    //! \brief Number of fast retransmissions (each starts one episode of fast recovery)
+    uint64_t fast_retransmits() const { return _fast_retransmits; }
+
+    //! \brief Number of segments resent because the SACK scoreboard showed them lost
+    uint64_t sack_retransmits() const { return _sack_retransmits; }
+
+    //! \brief Number of tail loss probes sent
+    uint64_t tail_loss_probes() const { return _tail_loss_probes; }
+
+    //! \brief Number of sequence numbers above the ackno that the peer has selectively acknowledged
+    uint64_t sacked_bytes() const { return _sacked.size(); }
+
+    //! \brief The timestamp clock: the sender's clock in milliseconds, modulo 2^32, to put in TSval
+    uint32_t timestamp() const { return static_cast<uint32_t>(_now_ms); }
+
+    //! \brief Largest payload the sender puts in one segment
+    size_t mss() const { return _mss; }
+
+    //! \brief The rate at which new segments are released, in bytes per second (0 if they are not paced)
+    uint64_t pacing_rate() const;
+
+    //! \brief Milliseconds until pacing lets the next segment go, if a segment is waiting only for that
+    //! \details The owner can use this to tick the sender exactly when the segment is due.
+    std::optional<size_t> next_send_delay() const;
+
+    //! \brief Milliseconds until tick() next has work to do: the retransmission timer expires or paced data
+    //! is due; nothing if neither is pending
+    std::optional<size_t> next_timeout() const;
+
+    //! \brief The congestion-control algorithm, or nullptr if there is none
+    const CongestionControl *congestion_control() const { return _congestion_control.get(); }
+
     //! \brief TCPSegments that the TCPSender has enqueued for transmission.
     //! \note These must be dequeued and sent by the TCPConnection,
     //! which will need to fill in the fields that are set by the TCPReceiver
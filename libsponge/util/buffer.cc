@@ -7,7 +7,18 @@ void Buffer::remove_prefix(const size_t n) {
         throw out_of_range("Buffer::remove_prefix");
     }
     _starting_offset += n;
-    if (_storage and _starting_offset == _storage->size()) {
+    _length -= n;
+    if (_storage and _length == 0) {
+        _storage.reset();
+    }
+}
+
+void Buffer::remove_suffix(const size_t n) {
+    if (n > str().size()) {
+        throw out_of_range("Buffer::remove_suffix");
+    }
+    _length -= n;
+    if (_storage and _length == 0) {
         _storage.reset();
     }
 }
@@ -70,6 +81,14 @@ BufferViewList::BufferViewList(const BufferList &buffers) {
     }
 }
 
+BufferViewList::BufferViewList(string_view first, string_view second) {
+    for (const auto &x : {first, second}) {
+        if (not x.empty()) {
+            _views.push_back(x);
+        }
+    }
+}
+
 void BufferViewList::remove_prefix(size_t n) {
     while (n > 0) {
         if (_views.empty()) {
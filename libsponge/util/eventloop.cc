@@ -25,14 +25,30 @@ void EventLoop::add_rule(const FileDescriptor &fd,
                          const CallbackT &callback,
                          const InterestT &interest,
                          const CallbackT &cancel) {
-    _rules.push_back({fd.duplicate(), direction, callback, interest, cancel});
+    _rules.push_back({fd.duplicate(), direction, callback, interest, cancel, std::nullopt});
+}
+
+//! \param[in] fd is the FileDescriptor to be polled
+//! \param[in] direction indicates whether to poll for reading (Direction::In) or writing (Direction::Out)
+//! \param[in] callback is called when `fd` is ready.
+//! \param[in] armed is the initial state of the returned switch
+//! \param[in] cancel is called when the rule is cancelled (e.g. on hangup, EOF, or closure).
+//! \returns an EventLoop::Arm; `fd` is polled only while it is armed
+EventLoop::Arm EventLoop::add_armed_rule(const FileDescriptor &fd,
+                                         const Direction direction,
+                                         const CallbackT &callback,
+                                         const bool armed,
+                                         const CallbackT &cancel) {
+    Arm arm{armed};
+    _rules.push_back({fd.duplicate(), direction, callback, [] { return false; }, cancel, arm});
+    return arm;
 }
 
 //! \param[in] timeout_ms is the timeout value passed to [poll(2)](\ref man2::poll); `wait_next_event`
 //!                       returns Result::Timeout if no fd is ready after the timeout expires.
 //! \returns Eventloop::Result indicating success, timeout, or no more Rule objects to poll.
 //!
-//! For each Rule, this function first calls Rule::interest; if `true`, Rule::fd is added to the
+//! For each Rule, this function first checks Rule::interested(); if `true`, Rule::fd is added to the
 //! list of file descriptors to be polled for readability (if Rule::direction == Direction::In) or
 //! writability (if Rule::direction == Direction::Out) unless Rule::fd has reached EOF, in which case
 //! the Rule is canceled (i.e., deleted from EventLoop::_rules).
@@ -79,7 +95,7 @@ EventLoop::Result EventLoop::wait_next_event(const int timeout_ms) {
             continue;
         }
 
-        if (this_rule.interest()) {
+        if (this_rule.interested()) {
             pollfds.push_back({this_rule.fd.fd_num(), static_cast<short>(this_rule.direction), 0});
             something_to_poll = true;
         } else {
@@ -132,7 +148,7 @@ EventLoop::Result EventLoop::wait_next_event(const int timeout_ms) {
             this_rule.callback();
 
             // only check for busy wait if we're not canceling or exiting
-            if (count_before == this_rule.service_count() and this_rule.interest()) {
+            if (count_before == this_rule.service_count() and this_rule.interested()) {
                 throw runtime_error(
                     "EventLoop: busy wait detected: callback did not read/write fd and is still interested");
             }
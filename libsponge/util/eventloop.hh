@@ -6,6 +6,8 @@
 #include <cstdlib>
 #include <functional>
 #include <list>
+#include <memory>
+#include <optional>
 #include <poll.h>
 
 //! Waits for events on file descriptors and executes corresponding callbacks.
@@ -17,6 +19,21 @@ class EventLoop {
         Out = POLLOUT  //!< Callback will be triggered when Rule::fd is writable.
     };
 
+    //! \brief A switch that turns a rule added by EventLoop::add_armed_rule on and off.
+    //! \details Owners flip it when the state the rule depends on changes (e.g. from a
+    //! ByteStream watermark callback), so the EventLoop does not have to ask on every wakeup.
+    class Arm {
+        std::shared_ptr<bool> _armed;
+
+      public:
+        //! Construct a switch in the given state
+        explicit Arm(const bool armed) : _armed(std::make_shared<bool>(armed)) {}
+
+        void arm() { *_armed = true; }      //!< Poll the rule's fd from now on
+        void disarm() { *_armed = false; }  //!< Stop polling the rule's fd
+        bool armed() const { return *_armed; }
+    };
+
   private:
     using CallbackT = std::function<void(void)>;  //!< Callback for ready Rule::fd
     using InterestT = std::function<bool(void)>;  //!< `true` return indicates Rule::fd should be polled.
@@ -30,6 +47,10 @@ class EventLoop {
         CallbackT callback;   //!< A callback that reads or writes fd.
         InterestT interest;   //!< A callback that returns `true` whenever fd should be polled.
         CallbackT cancel;     //!< A callback that is called when the rule is cancelled (e.g. on hangup)
+        std::optional<Arm> arm;  //!< If set, decides whether fd is polled, in place of Rule::interest
+
+        //! Returns `true` if fd should be polled, according to Rule::arm or Rule::interest.
+        bool interested() const { return arm ? arm->armed() : interest(); }
 
         //! Returns the number of times fd has been read or written, depending on the value of Rule::direction.
         //! \details This function is used internally by EventLoop; you will not need to call it
@@ -53,6 +74,14 @@ class EventLoop {
                   const InterestT &interest = [] { return true; },
                   const CallbackT &cancel = [] {});
 
+    //! Add a rule that is polled only while the returned Arm is armed.
+    //! \returns the switch that arms and disarms the rule
+    Arm add_armed_rule(const FileDescriptor &fd,
+                       const Direction direction,
+                       const CallbackT &callback,
+                       const bool armed = true,
+                       const CallbackT &cancel = [] {});
+
     //! Calls [poll(2)](\ref man2::poll) and then executes callback for each ready fd.
     Result wait_next_event(const int timeout_ms);
 };
@@ -69,6 +98,9 @@ using Direction = EventLoop::Direction;
 //! (for Rule::direction == Direction::In) or writable (for Rule::direction == Direction::Out).
 //! Once this occurs, the Rule is canceled, i.e., the EventLoop deletes it.
 //!
+//! A Rule installed using EventLoop::add_armed_rule has no `interest` callback. Instead it is polled
+//! while its EventLoop::Arm is armed; the owner arms and disarms it when the relevant state changes.
+//!
 //! A Rule installed using EventLoop::add_cancelable_rule will be polled and canceled under the
 //! same conditions, with the additional condition that if Rule::callback returns `true`, the
 //! Rule will be canceled.
@@ -61,6 +61,10 @@ class FileDescriptor {
     //! Read up to `limit` bytes into `str` (caller can allocate storage)
     void read(std::string &str, const size_t limit = std::numeric_limits<size_t>::max());
 
+    //! Read into discontiguous buffers with a single [readv(2)](\ref man2::readv) call
+    //! \returns the number of bytes read
+    size_t read(const std::vector<iovec> &iovecs);
+
     //! Write a string, possibly blocking until all is written
     size_t write(const char *str, const bool write_all = true) { return write(BufferViewList(str), write_all); }
 
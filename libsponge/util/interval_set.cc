@@ -0,0 +1,73 @@
+#include "interval_set.hh"
+
+#include <algorithm>
+
+using namespace std;
+
+//! \param[in] begin is the first index to add
+//! \param[in] end is one past the last index to add
+void IntervalSet::insert(const uint64_t begin, const uint64_t end) {
+    if (begin >= end) {
+        return;
+    }
+
+    // the first range that overlaps or touches [begin, end), if any
+    auto first = lower_bound(
+        _intervals.begin(), _intervals.end(), begin, [](const Interval &iv, const uint64_t idx) { return iv.end < idx; });
+    // one past the last such range
+    auto last = first;
+    Interval merged{begin, end};
+    while (last != _intervals.end() and last->begin <= end) {
+        merged.begin = min(merged.begin, last->begin);
+        merged.end = max(merged.end, last->end);
+        _size -= last->end - last->begin;
+        ++last;
+    }
+    _size += merged.end - merged.begin;
+
+    if (first == last) {
+        _intervals.insert(first, merged);
+    } else {
+        *first = merged;
+        _intervals.erase(first + 1, last);
+    }
+}
+
+//! \param[in] end is one past the last index to remove
+void IntervalSet::remove_prefix(const uint64_t end) {
+    auto it = _intervals.begin();
+    while (it != _intervals.end() and it->end <= end) {
+        _size -= it->end - it->begin;
+        ++it;
+    }
+    _intervals.erase(_intervals.begin(), it);
+
+    if (not _intervals.empty() and _intervals.front().begin < end) {
+        _size -= end - _intervals.front().begin;
+        _intervals.front().begin = end;
+    }
+}
+
+void IntervalSet::clear() {
+    _intervals.clear();
+    _size = 0;
+}
+
+//! \param[in] index is the index to look up
+bool IntervalSet::contains(const uint64_t index) const {
+    const auto it = upper_bound(
+        _intervals.begin(), _intervals.end(), index, [](const uint64_t idx, const Interval &iv) { return idx < iv.end; });
+    return it != _intervals.end() and it->begin <= index;
+}
+
+//! \param[in] begin is the first index to look up
+//! \param[in] end is one past the last index to look up
+bool IntervalSet::covers(const uint64_t begin, const uint64_t end) const {
+    if (begin >= end) {
+        return true;
+    }
+    // ranges never touch, so [begin, end) is covered only if a single range holds all of it
+    const auto it = upper_bound(
+        _intervals.begin(), _intervals.end(), begin, [](const uint64_t idx, const Interval &iv) { return idx < iv.end; });
+    return it != _intervals.end() and it->begin <= begin and end <= it->end;
+}
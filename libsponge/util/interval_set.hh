@@ -0,0 +1,48 @@
+#ifndef SPONGE_LIBSPONGE_INTERVAL_SET_HH
+#define SPONGE_LIBSPONGE_INTERVAL_SET_HH
+
+#include <cstdint>
+#include <vector>
+
+//! \brief A set of byte indices, stored as sorted, disjoint, non-adjacent half-open ranges
+
+//! The ranges live in a single contiguous vector. Receivers rarely see more than a
+//! handful of holes at once, so a binary search plus a short shift beats a node-based
+//! container, and once the vector has grown to its working size no insert allocates.
+class IntervalSet {
+  public:
+    //! A range of indices [begin, end)
+    struct Interval {
+        uint64_t begin;  //!< first index in the range
+        uint64_t end;    //!< one past the last index in the range
+    };
+
+  private:
+    std::vector<Interval> _intervals{};
+    uint64_t _size{};  //!< Total number of indices covered by `_intervals`
+
+  public:
+    //! Add [begin, end) to the set, merging it with any ranges it overlaps or touches
+    void insert(const uint64_t begin, const uint64_t end);
+
+    //! Remove every index below `end` from the set
+    void remove_prefix(const uint64_t end);
+
+    //! Remove every index from the set
+    void clear();
+
+    //! \returns `true` if `index` is in the set
+    bool contains(const uint64_t index) const;
+
+    //! \returns `true` if every index in [begin, end) is in the set
+    bool covers(const uint64_t begin, const uint64_t end) const;
+
+    //! \name Accessors
+    //!@{
+    bool empty() const { return _intervals.empty(); }                      //!< no indices in the set
+    uint64_t size() const { return _size; }                                //!< number of indices in the set
+    const std::vector<Interval> &intervals() const { return _intervals; }  //!< the ranges, in order
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_INTERVAL_SET_HH
@@ -0,0 +1,109 @@
+#include "mapped_temp_file.hh"
+
+#include "util.hh"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+using namespace std;
+
+//! \param[in] size is the length of the region to create, in bytes
+MappedTempFile::MappedTempFile(const size_t size) : _size(size) {
+    if (size == 0) {
+        return;
+    }
+
+    const char *tmpdir = getenv("TMPDIR");
+    string path = string(tmpdir != nullptr ? tmpdir : "/tmp") + "/sponge-stream-XXXXXX";
+    _fd = SystemCall("mkstemp", ::mkstemp(path.data()));
+    // nobody else needs to find the file; it lives on only as long as the descriptor and mapping do
+    SystemCall("unlink", ::unlink(path.c_str()));
+    SystemCall("ftruncate", ::ftruncate(_fd, static_cast<off_t>(size)));
+
+    void *const addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (addr == MAP_FAILED) {
+        throw unix_error("mmap");
+    }
+    _data = static_cast<char *>(addr);
+
+    // streams touch the region front to back, so aggressive read-ahead and early eviction both pay off
+    ::madvise(_data, _size, MADV_SEQUENTIAL);
+}
+
+void MappedTempFile::unmap() {
+    if (_data != nullptr) {
+        SystemCall("munmap", ::munmap(_data, _size));
+        _data = nullptr;
+    }
+    if (_fd >= 0) {
+        SystemCall("close", ::close(_fd));
+        _fd = -1;
+    }
+}
+
+MappedTempFile::~MappedTempFile() {
+    try {
+        unmap();
+    } catch (const exception &e) {
+        // don't throw an exception from the destructor
+        std::cerr << "Exception destructing MappedTempFile: " << e.what() << std::endl;
+    }
+}
+
+//! \param[in] offset is the start of the range that is no longer needed
+//! \param[in] len is the length of the range
+void MappedTempFile::discard(const size_t offset, const size_t len) {
+    const size_t page = page_size();
+
+    // the mapping ends on a page boundary, so the partial page at the end of the region is whole
+    const size_t first_page = (offset + page - 1) / page * page;
+    const size_t end_page = offset + len >= _size ? (_size + page - 1) / page * page : (offset + len) / page * page;
+    if (_data == nullptr or first_page >= end_page) {
+        return;
+    }
+
+    // punch a hole in the file, so the kernel neither keeps nor writes back bytes nobody will read;
+    // this is only a hint, so failure (e.g. on a filesystem without hole punching) is harmless
+    ::madvise(_data + first_page, end_page - first_page, MADV_REMOVE);
+}
+
+size_t MappedTempFile::page_size() {
+    static const size_t page = ::sysconf(_SC_PAGESIZE);
+    return page;
+}
+
+MappedTempFile::MappedTempFile(const MappedTempFile &other) : MappedTempFile(other._size) {
+    if (_size > 0) {
+        memcpy(_data, other._data, _size);
+    }
+}
+
+MappedTempFile &MappedTempFile::operator=(const MappedTempFile &other) {
+    if (this != &other) {
+        MappedTempFile copy{other};
+        *this = move(copy);
+    }
+    return *this;
+}
+
+MappedTempFile::MappedTempFile(MappedTempFile &&other) noexcept
+    : _fd(exchange(other._fd, -1)), _data(exchange(other._data, nullptr)), _size(exchange(other._size, 0)) {}
+
+MappedTempFile &MappedTempFile::operator=(MappedTempFile &&other) noexcept {
+    if (this != &other) {
+        try {
+            unmap();
+        } catch (const exception &e) {
+            std::cerr << "Exception replacing MappedTempFile: " << e.what() << std::endl;
+        }
+        _fd = exchange(other._fd, -1);
+        _data = exchange(other._data, nullptr);
+        _size = exchange(other._size, 0);
+    }
+    return *this;
+}
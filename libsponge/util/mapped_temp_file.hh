@@ -0,0 +1,57 @@
+#ifndef SPONGE_LIBSPONGE_MAPPED_TEMP_FILE_HH
+#define SPONGE_LIBSPONGE_MAPPED_TEMP_FILE_HH
+
+#include <cstddef>
+
+//! \brief A fixed-size region of memory backed by an unlinked temporary file
+
+//! The region is a shared [mmap(2)](\ref man2::mmap) of the file, so the kernel
+//! is free to write cold pages back to disk and evict them from RAM. Only the
+//! pages that are actually being touched need to stay resident, which lets the
+//! region be far larger than the memory the process is willing to pin.
+class MappedTempFile {
+  private:
+    int _fd{-1};           //!< Descriptor of the (already unlinked) backing file
+    char *_data{nullptr};  //!< Start of the mapping
+    size_t _size{0};       //!< Length of the mapping, in bytes
+
+    //! Unmap the region (if any) and close the backing file
+    void unmap();
+
+  public:
+    //! Construct an empty mapping
+    MappedTempFile() = default;
+
+    //! Create a temporary file of `size` bytes and map it
+    explicit MappedTempFile(const size_t size);
+
+    //! Unmaps the region; the kernel frees the file once the last reference is gone
+    ~MappedTempFile();
+
+    //! \name Accessors
+    //!@{
+    char *data() { return _data; }              //!< start of the region
+    const char *data() const { return _data; }  //!< start of the region
+    size_t size() const { return _size; }       //!< length of the region
+    //!@}
+
+    //! \brief Tell the kernel that the bytes in [offset, offset + len) are no longer needed
+    //! \details Whole pages inside the range are dropped from memory and from the file
+    //! (reading them again yields zeros); partial pages at either end are left alone, except
+    //! that a range reaching the end of the region takes its last page with it.
+    void discard(const size_t offset, const size_t len);
+
+    //! The granularity of discard(), in bytes
+    static size_t page_size();
+
+    //! \name Copy/move constructor/assignment operators
+    //! Copying creates a new temporary file with the same contents
+    //!@{
+    MappedTempFile(const MappedTempFile &other);
+    MappedTempFile &operator=(const MappedTempFile &other);
+    MappedTempFile(MappedTempFile &&other) noexcept;
+    MappedTempFile &operator=(MappedTempFile &&other) noexcept;
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_MAPPED_TEMP_FILE_HH
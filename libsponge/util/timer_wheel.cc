@@ -0,0 +1,161 @@
+#include "timer_wheel.hh"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace std;
+
+//! \param[in] now_ms is the initial reading of the wheel's clock
+TimerWheel::TimerWheel(const uint64_t now_ms) : _now(now_ms), _lists(OVERFLOW_LIST + 1) {}
+
+//! \param[in] deadline is the time at which a timer expires
+size_t TimerWheel::list_for(const uint64_t deadline) const {
+    if (deadline <= _now) {
+        return DUE_LIST;
+    }
+
+    // the highest group of SLOT_BITS bits in which the deadline differs from the current time
+    const uint64_t differing = deadline ^ _now;
+    unsigned level = 0;
+    while (level < LEVELS and (differing >> ((level + 1) * SLOT_BITS)) != 0) {
+        level++;
+    }
+    if (level == LEVELS) {
+        return OVERFLOW_LIST;
+    }
+    return level * SLOTS + ((deadline >> (level * SLOT_BITS)) & (SLOTS - 1));
+}
+
+//! \param[in,out] location is where the timer is now, and is updated to where it goes
+//! \param[in] list is the index of the list to move it to
+void TimerWheel::move_to(Location &location, const size_t list) {
+    const size_t from = location.list;
+    _lists[list].splice(_lists[list].end(), _lists[from], location.node);
+    location.list = list;
+
+    if (from < DUE_LIST and _lists[from].empty()) {
+        _occupied[from / SLOTS] &= ~(uint64_t{1} << (from % SLOTS));
+    }
+    if (list < DUE_LIST) {
+        _occupied[list / SLOTS] |= uint64_t{1} << (list % SLOTS);
+    }
+}
+
+//! \param[in] list is the index of a list whose slot the clock has just reached
+void TimerWheel::replace_all(const size_t list) {
+    auto node = _lists[list].begin();
+    while (node != _lists[list].end()) {
+        // moving the node invalidates nothing but our position in this list
+        const auto next = std::next(node);
+        Location &location = _timers.at(node->key);
+        const size_t target = list_for(node->deadline);
+        if (target != list) {
+            move_to(location, target);
+        }
+        node = next;
+    }
+}
+
+//! \param[out] expired receives the keys of the due timers
+void TimerWheel::take_due(vector<uint64_t> &expired) {
+    for (const auto &timer : _lists[DUE_LIST]) {
+        expired.push_back(timer.key);
+        _timers.erase(timer.key);
+    }
+    _lists[DUE_LIST].clear();
+}
+
+//! \param[in] key identifies the timer
+//! \param[in] deadline_ms is when the timer expires
+void TimerWheel::schedule(const uint64_t key, const uint64_t deadline_ms) {
+    const size_t list = list_for(deadline_ms);
+    const auto existing = _timers.find(key);
+    if (existing != _timers.end()) {
+        existing->second.node->deadline = deadline_ms;
+        move_to(existing->second, list);
+        return;
+    }
+
+    _lists[list].push_back({key, deadline_ms});
+    _timers.emplace(key, Location{list, prev(_lists[list].end())});
+    if (list < DUE_LIST) {
+        _occupied[list / SLOTS] |= uint64_t{1} << (list % SLOTS);
+    }
+}
+
+//! \param[in] key identifies the timer
+bool TimerWheel::cancel(const uint64_t key) {
+    const auto existing = _timers.find(key);
+    if (existing == _timers.end()) {
+        return false;
+    }
+
+    const size_t list = existing->second.list;
+    _lists[list].erase(existing->second.node);
+    if (list < DUE_LIST and _lists[list].empty()) {
+        _occupied[list / SLOTS] &= ~(uint64_t{1} << (list % SLOTS));
+    }
+    _timers.erase(existing);
+    return true;
+}
+
+optional<uint64_t> TimerWheel::next_wakeup() const {
+    if (not _lists[DUE_LIST].empty()) {
+        return _now;
+    }
+
+    // Every timer in a level lies in a slot after the current one, within the current slot of the level
+    // above; so the first occupied slot found, going up from level 0, is the earliest.
+    for (unsigned level = 0; level < LEVELS; level++) {
+        const unsigned shift = level * SLOT_BITS;
+        const uint64_t index = (_now >> shift) & (SLOTS - 1);
+        const uint64_t later = index + 1 == SLOTS ? 0 : _occupied[level] & (~uint64_t{0} << (index + 1));
+        if (later != 0) {
+            const uint64_t block_start = _now >> (shift + SLOT_BITS) << (shift + SLOT_BITS);
+            return block_start | (uint64_t{static_cast<unsigned>(__builtin_ctzll(later))} << shift);
+        }
+    }
+
+    if (not _lists[OVERFLOW_LIST].empty()) {
+        // the start of the next span of the top level, when the overflow is sorted again
+        constexpr unsigned span_bits = LEVELS * SLOT_BITS;
+        return ((_now >> span_bits) + 1) << span_bits;
+    }
+    return {};
+}
+
+//! \param[in] now_ms is the new reading of the clock; a time in the past leaves the clock where it is
+vector<uint64_t> TimerWheel::advance(const uint64_t now_ms) {
+    vector<uint64_t> expired;
+    take_due(expired);
+
+    for (auto wakeup = next_wakeup(); wakeup.has_value() and wakeup.value() <= now_ms; wakeup = next_wakeup()) {
+        _now = wakeup.value();
+
+        // Sort the timers of every slot that starts now into lower levels, top level first. The level-0 slot
+        // always starts now, and all its timers are due.
+        constexpr unsigned span_bits = LEVELS * SLOT_BITS;
+        if ((_now & ((uint64_t{1} << span_bits) - 1)) == 0) {
+            replace_all(OVERFLOW_LIST);
+        }
+        for (unsigned level = LEVELS; level-- > 0;) {
+            const unsigned shift = level * SLOT_BITS;
+            if ((_now & ((uint64_t{1} << shift) - 1)) == 0) {
+                replace_all(level * SLOTS + ((_now >> shift) & (SLOTS - 1)));
+            }
+        }
+        take_due(expired);
+    }
+
+    _now = max(_now, now_ms);
+    return expired;
+}
+
+//! \param[in] key identifies the timer
+optional<uint64_t> TimerWheel::deadline(const uint64_t key) const {
+    const auto existing = _timers.find(key);
+    if (existing == _timers.end()) {
+        return {};
+    }
+    return existing->second.node->deadline;
+}
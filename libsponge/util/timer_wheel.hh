@@ -0,0 +1,89 @@
+#ifndef SPONGE_LIBSPONGE_TIMER_WHEEL_HH
+#define SPONGE_LIBSPONGE_TIMER_WHEEL_HH
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+//! \brief A hierarchical timing wheel: many one-shot timers, each identified by a key, with millisecond deadlines
+
+//! Level 0 has one slot per millisecond; each higher level has slots SLOTS times as wide. A timer sits in the
+//! level of the highest group of SLOT_BITS bits in which its deadline differs from the current time, and drops
+//! to lower levels as time reaches its slot, so advancing the wheel costs time proportional to the timers that
+//! expire or move, not to the number of timers or to the milliseconds elapsed. Deadlines beyond the top level
+//! wait in an overflow list. Scheduling, rescheduling and cancelling a timer are O(1) and do not allocate once
+//! the timer exists.
+class TimerWheel {
+  public:
+    static constexpr unsigned SLOT_BITS = 6;                 //!< log2 of the number of slots per level
+    static constexpr size_t SLOTS = size_t{1} << SLOT_BITS;  //!< slots per level
+    static constexpr unsigned LEVELS = 4;                    //!< levels; together they span 2^24 ms, about 4.6 hours
+
+  private:
+    struct Timer {
+        uint64_t key;
+        uint64_t deadline;
+    };
+    using TimerList = std::list<Timer>;
+
+    //! Index of the list of timers that are due but not yet returned by advance()
+    static constexpr size_t DUE_LIST = LEVELS * SLOTS;
+    //! Index of the list of timers too far in the future for the top level
+    static constexpr size_t OVERFLOW_LIST = DUE_LIST + 1;
+
+    //! Where a timer is: the index of its list, and its node in that list
+    struct Location {
+        size_t list;
+        TimerList::iterator node;
+    };
+
+    uint64_t _now;
+    std::vector<TimerList> _lists;                     //!< the slots, level by level, then the two lists above
+    std::array<uint64_t, LEVELS> _occupied{};          //!< per level, a bit for each non-empty slot
+    std::unordered_map<uint64_t, Location> _timers{};  //!< every running timer, by key
+
+    //! \returns the index of the list a timer with this deadline belongs in, at the current time
+    size_t list_for(const uint64_t deadline) const;
+
+    //! Move a timer's node to the end of list `list`, keeping the occupancy bits up to date
+    void move_to(Location &location, const size_t list);
+
+    //! Put each timer in list `list` where it belongs now (used when time reaches the list's slot)
+    void replace_all(const size_t list);
+
+    //! Append the keys of the due timers to `expired`, and forget those timers
+    void take_due(std::vector<uint64_t> &expired);
+
+  public:
+    //! Construct an empty wheel whose clock reads `now_ms`
+    explicit TimerWheel(const uint64_t now_ms = 0);
+
+    //! Start the timer `key`, to expire at `deadline_ms`, or move it there if it is already running
+    //! \note A deadline that has already passed expires at the next call to advance()
+    void schedule(const uint64_t key, const uint64_t deadline_ms);
+
+    //! Stop the timer `key`
+    //! \returns `true` if it was running
+    bool cancel(const uint64_t key);
+
+    //! Move the clock forward to `now_ms`
+    //! \returns the keys of the timers that expired, in the order they expired
+    std::vector<uint64_t> advance(const uint64_t now_ms);
+
+    //! \returns the earliest time at which advance() has work to do (no later than the earliest deadline),
+    //! or nothing if no timer is running
+    std::optional<uint64_t> next_wakeup() const;
+
+    //! \name Accessors
+    //!@{
+    uint64_t now() const { return _now; }                        //!< the wheel's clock, in milliseconds
+    size_t size() const { return _timers.size(); }               //!< number of running timers
+    std::optional<uint64_t> deadline(const uint64_t key) const;  //!< when timer `key` expires, if it is running
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_TIMER_WHEEL_HH
@@ -0,0 +1,103 @@
+#include "byte_stream.hh"
+#include "byte_stream_test_harness.hh"
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+int main() {
+    try {
+        const auto chain = ByteStream::Storage::BufferChain;
+
+        {
+            ByteStreamTestHarness test{"chain-overwrite-pop-overwrite", 2, chain};
+
+            test.execute(Write{"cat"}.with_bytes_written(2));
+            test.execute(Pop{1});
+            test.execute(WriteBuffer{Buffer{"tac"}}.with_bytes_written(1));
+
+            test.execute(InputEnded{false});
+            test.execute(BufferEmpty{false});
+            test.execute(Eof{false});
+            test.execute(BytesRead{1});
+            test.execute(BytesWritten{3});
+            test.execute(RemainingCapacity{0});
+            test.execute(BufferSize{2});
+            test.execute(Peek{"at"});
+        }
+
+        {
+            ByteStreamTestHarness test{"chain-many-buffers", 10, chain};
+
+            test.execute(WriteBuffer{Buffer{"abc"}});
+            test.execute(Write{"def"});
+            test.execute(WriteBuffer{Buffer{"ghijkl"}}.with_bytes_written(4));
+            test.execute(Peek{"abcdefghij"});
+            test.execute(Pop{4});
+            test.execute(Peek{"efghij"});
+            test.execute(RemainingCapacity{4});
+            test.execute(EndInput{});
+            test.execute(Pop{6});
+            test.execute(Eof{true});
+            test.execute(BytesRead{10});
+            test.execute(BytesWritten{10});
+        }
+
+        {
+            // bytes written as a Buffer must come back out sharing the same storage
+            ByteStream stream{100, chain};
+            const Buffer payload{string("hello, world")};
+            stream.write(payload);
+            stream.write(Buffer{"!"});
+
+            const BufferList out = stream.read_buffers(5);
+            if (out.size() != 5 or out.buffers().size() != 1 or out.buffers()[0].str() != "hello") {
+                throw runtime_error("read_buffers(5) returned the wrong bytes");
+            }
+            if (out.buffers()[0].str().data() != payload.str().data()) {
+                throw runtime_error("read_buffers() copied bytes that should have been shared");
+            }
+
+            const auto [first, second] = stream.peek_spans(100);
+            if (first != ", world" or second != "!") {
+                throw runtime_error("peek_spans() did not expose the first two Buffers");
+            }
+            if (stream.read_buffers(100).concatenate() != ", world!" or not stream.buffer_empty()) {
+                throw runtime_error("read_buffers() did not drain the stream");
+            }
+        }
+
+        {
+            // read_buffer() slices the first Buffer when it can, and coalesces (copies) only when it must
+            ByteStream stream{100, chain};
+            const Buffer payload{string("0123456789")};
+            stream.write(payload);
+            stream.write(Buffer{"abc"});
+
+            const Buffer head = stream.read_buffer(4);
+            if (head.str() != "0123" or head.str().data() != payload.str().data()) {
+                throw runtime_error("read_buffer() should share bytes within the first Buffer");
+            }
+            const Buffer rest = stream.read_buffer(8);
+            if (rest.str() != "456789ab" or stream.read_buffer(100).str() != "c" or not stream.buffer_empty()) {
+                throw runtime_error("read_buffer() across Buffers returned the wrong bytes");
+            }
+        }
+
+        {
+            // a ring-backed stream accepts Buffers too, copying them in
+            ByteStream stream{4};
+            BufferList list{Buffer{"ab"}};
+            list.append(Buffer{"cdef"});
+            if (stream.write(list) != 4 or stream.read_buffers(4).concatenate() != "abcd") {
+                throw runtime_error("ring-backed stream mishandled a BufferList");
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
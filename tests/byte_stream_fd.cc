@@ -0,0 +1,103 @@
+#include "byte_stream.hh"
+#include "file_descriptor.hh"
+#include "mapped_temp_file.hh"
+#include "test_err_if.hh"
+#include "util.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+
+static pair<FileDescriptor, FileDescriptor> make_pipe() {
+    int fds[2];
+    SystemCall("pipe", ::pipe(static_cast<int *>(fds)));
+    return {FileDescriptor(fds[0]), FileDescriptor(fds[1])};
+}
+
+int main() {
+    try {
+        for (const auto storage :
+             {ByteStream::Storage::Ring, ByteStream::Storage::BufferChain, ByteStream::Storage::MappedFile}) {
+            auto [read_end, write_end] = make_pipe();
+            ByteStream stream{8, storage};
+
+            // fill part of the ring and drain it, so that the next read from the pipe wraps around
+            stream.write("abcde");
+            stream.pop_output(5);
+
+            write_end.write("0123456789");
+            test_err_if(stream.write_from(read_end, 100) != 8, "write_from should stop at the stream's capacity");
+            test_err_if(stream.peek_output(8) != "01234567", "write_from stored the wrong bytes");
+            test_err_if(stream.bytes_written() != 13, "write_from should count bytes written");
+
+            auto [out_read_end, out_write_end] = make_pipe();
+            test_err_if(stream.read_into(out_write_end, 6) != 6, "read_into should write up to its limit");
+            test_err_if(stream.buffer_size() != 2 or stream.bytes_read() != 11, "read_into should pop what it wrote");
+            test_err_if(out_read_end.read(100) != "012345", "read_into wrote the wrong bytes");
+
+            test_err_if(stream.write_from(read_end, 100) != 2, "write_from should pick up the rest of the pipe");
+            write_end.close();
+            test_err_if(stream.write_from(read_end, 100) != 0 or not read_end.eof(), "write_from should detect EOF");
+            test_err_if(stream.read(100) != "6789", "stream should hold the rest of the pipe's bytes");
+        }
+
+        {
+            // popped pages of a memory-mapped stream are discarded; the unread bytes must survive that
+            ByteStream stream{3 * 4096 + 100, ByteStream::Storage::MappedFile};
+            size_t next_written = 0;
+            size_t next_read = 0;
+            for (unsigned round = 0; round < 20; round++) {
+                string chunk;
+                for (size_t i = 0; i < 5000; i++) {
+                    chunk.push_back(static_cast<char>((next_written + i) % 253));
+                }
+                next_written += stream.write(chunk);
+                for (const char c : stream.read(4321)) {
+                    test_err_if(c != static_cast<char>(next_read % 253), "mapped stream lost bytes across a discard");
+                    next_read++;
+                }
+            }
+            test_err_if(stream.bytes_read() != next_read, "mapped stream accounting mismatch");
+        }
+
+        {
+            // pops smaller than a page still release every page the head has left behind
+            const size_t page = MappedTempFile::page_size();
+            ByteStream stream{8 * page, ByteStream::Storage::MappedFile};
+            stream.write(string(6 * page, 'x'));
+            const char *const ring = stream.peek_spans(1).first.data();
+            const auto resident = [&](const size_t index) {
+                unsigned char vec = 0;
+                SystemCall("mincore", ::mincore(const_cast<char *>(ring + index * page), page, &vec));
+                return (vec & 1) != 0;
+            };
+            test_err_if(not resident(0) or not resident(5), "written pages should be resident");
+
+            while (stream.bytes_read() < 4 * page + page / 2) {
+                stream.pop_output(1000);
+            }
+            for (size_t index = 0; index < 4; index++) {
+                test_err_if(resident(index), "page " + to_string(index) + " was popped but not released");
+            }
+            test_err_if(not resident(4) or not resident(5), "pages with unread bytes should be kept");
+
+            // once the writer has wrapped around into the head's page, that page must be kept
+            ByteStream wrapped{3 * page, ByteStream::Storage::MappedFile};
+            wrapped.write(string(2 * page + 100, 'a'));
+            wrapped.pop_output(2 * page + 50);
+            wrapped.write(string(3 * page - 50, 'b'));
+            wrapped.pop_output(1000);
+            test_err_if(wrapped.read(3 * page) != string(3 * page - 1000, 'b'),
+                        "a discard behind the head should not reach bytes that wrapped around");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,55 @@
+#include "byte_stream.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        for (const auto storage :
+             {ByteStream::Storage::Ring, ByteStream::Storage::BufferChain, ByteStream::Storage::MappedFile}) {
+            ByteStream stream{10, storage};
+            unsigned readable = 0, drained = 0, writable = 0;
+            stream.on_readable([&] { readable++; }, 4);
+            stream.on_drained([&] { drained++; }, 2);
+            stream.on_writable([&] { writable++; }, 5);
+
+            stream.write("ab");
+            test_err_if(readable != 0, "readable fired below its high watermark");
+            stream.write("cdefgh");
+            test_err_if(readable != 1, "readable should fire on crossing its high watermark");
+            stream.write("ij");
+            test_err_if(readable != 1, "readable should not fire again while above the watermark");
+
+            stream.pop_output(4);
+            test_err_if(writable != 0, "writable fired with too little room");
+            stream.pop_output(1);
+            test_err_if(writable != 1, "writable should fire once there is enough room");
+            test_err_if(drained != 0, "drained fired above its low watermark");
+            stream.pop_output(4);
+            test_err_if(drained != 1, "drained should fire on falling below its low watermark");
+            test_err_if(writable != 1, "writable should not fire again while above the watermark");
+
+            stream.write("klmn");
+            test_err_if(readable != 2, "readable should fire again on a fresh crossing");
+            stream.end_input();
+            test_err_if(readable != 3, "end_input should fire readable once");
+            stream.end_input();
+            test_err_if(readable != 3, "a second end_input should not fire again");
+
+            ByteStream ended{10, storage};
+            unsigned ended_readable = 0;
+            ended.on_readable([&] { ended_readable++; });
+            ended.end_input();
+            test_err_if(ended_readable != 1, "end_input should make an empty stream readable");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
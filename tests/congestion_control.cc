@@ -0,0 +1,86 @@
+#include "congestion_control.hh"
+#include "tcp_config.hh"
+#include "tcp_sender.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        constexpr size_t MSS = 1000;
+
+        {
+            RenoCongestionControl reno{MSS};
+            test_err_if(reno.cwnd() != 10 * MSS, "initial window should be ten segments");
+            reno.on_ack({MSS, 0, 0});
+            test_err_if(reno.cwnd() != 11 * MSS, "slow start should grow by the bytes acked");
+
+            reno.on_congestion_event(20 * MSS, 0);
+            test_err_if(reno.cwnd() != 10 * MSS or reno.ssthresh() != 10 * MSS, "loss should halve the flight size");
+            for (unsigned i = 0; i < 10; i++) {
+                reno.on_ack({MSS, 0, 0});
+            }
+            test_err_if(reno.cwnd() != 11 * MSS, "congestion avoidance should add one segment per window");
+
+            reno.on_retransmission_timeout(8 * MSS, 0);
+            test_err_if(reno.cwnd() != MSS or reno.ssthresh() != 4 * MSS, "timeout should restart slow start");
+        }
+
+        {
+            CubicCongestionControl cubic{MSS};
+            for (unsigned i = 0; i < 90; i++) {
+                cubic.on_ack({MSS, 0, 0, 10});
+            }
+            test_err_if(cubic.cwnd() != 100 * MSS, "slow start should reach 100 segments");
+            cubic.on_congestion_event(100 * MSS, 1000);
+            test_err_if(cubic.cwnd() != 70 * MSS, "loss should cut the window by beta");
+
+            // acks keep arriving, one per millisecond; the window climbs back towards and past w_max
+            uint64_t now = 1000;
+            uint64_t at_plateau = 0;
+            for (; now < 20000; now++) {
+                cubic.on_ack({MSS, 0, now, 10});
+                if (now == 1000 + 3000) {
+                    at_plateau = cubic.cwnd();
+                }
+            }
+            test_err_if(at_plateau <= 90 * MSS or at_plateau >= 110 * MSS, "window should plateau near w_max");
+            test_err_if(cubic.cwnd() <= 150 * MSS, "window should grow well past w_max later");
+        }
+
+        {
+            // a path with a 10 ms RTT that delivers 1000 bytes per millisecond (1 MB/s)
+            BBRCongestionControl bbr{MSS};
+            for (uint64_t now = 1; now <= 2000; now++) {
+                bbr.on_ack({MSS, 10 * MSS, now, 10});
+            }
+            test_err_if(bbr.bottleneck_bandwidth() != 1'000'000, "bandwidth estimate should match the delivery rate");
+            test_err_if(bbr.cwnd() != 20 * MSS, "window should settle at twice the bandwidth-delay product");
+            test_err_if(bbr.pacing_rate() < 750'000 or bbr.pacing_rate() > 1'250'000, "pacing should cycle around 1x");
+        }
+
+        {
+            // the sender keeps no more than the congestion window in flight
+            TCPConfig cfg;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.congestion_control = CongestionControl::Algorithm::Reno;
+            TCPSender sender{cfg};
+            sender.fill_window();
+            sender.ack_received(WrappingInt32{1}, 60000);
+            sender.stream_in().write(string(50000, 'x'));
+            sender.fill_window();
+            test_err_if(sender.congestion_control() == nullptr, "sender should have a congestion controller");
+            test_err_if(sender.bytes_in_flight() != sender.congestion_control()->cwnd(),
+                        "sender should fill exactly the congestion window, not the receiver's window");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
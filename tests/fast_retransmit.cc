@@ -0,0 +1,105 @@
+#include "tcp_config.hh"
+#include "tcp_connection.hh"
+#include "tcp_connection_test_helpers.hh"
+#include "tcp_sender.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+//! \returns the seqnos of the segments the sender queued, and empties its queue
+static vector<uint32_t> drain(TCPSender &sender) {
+    vector<uint32_t> seqnos;
+    while (not sender.segments_out().empty()) {
+        seqnos.push_back(sender.segments_out().front().header().seqno.raw_value());
+        sender.segments_out().pop();
+    }
+    return seqnos;
+}
+
+int main() {
+    try {
+        constexpr size_t MSS = TCPConfig::MAX_PAYLOAD_SIZE;
+
+        for (const bool enabled : {true, false}) {
+            TCPConfig cfg;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.fast_retransmit = enabled;
+            cfg.congestion_control = CongestionControl::Algorithm::Reno;
+            TCPSender sender{cfg};
+
+            sender.fill_window();
+            sender.ack_received(WrappingInt32{1}, 60000);
+            sender.stream_in().write(string(8 * MSS, 'x'));
+            sender.fill_window();
+            test_err_if(drain(sender).size() != 9, "SYN and eight segments should be sent");
+
+            // the segment at seqno 1001 is lost; the next segments each produce a duplicate ACK
+            sender.ack_received(WrappingInt32{1 + MSS}, 60000);
+            sender.ack_received(WrappingInt32{1 + MSS}, 60000);
+            sender.ack_received(WrappingInt32{1 + MSS}, 60000);
+            test_err_if(not drain(sender).empty(), "two duplicate ACKs should not trigger a retransmission");
+            sender.ack_received(WrappingInt32{1 + MSS}, 60000);
+
+            if (not enabled) {
+                test_err_if(not drain(sender).empty(), "without fast retransmit, only the RTO retransmits");
+                continue;
+            }
+
+            test_err_if(drain(sender) != vector<uint32_t>{1 + MSS},
+                        "the third duplicate ACK should retransmit the hole");
+            test_err_if(not sender.in_fast_recovery() or sender.fast_retransmits() != 1,
+                        "sender should be in fast recovery");
+
+            // a partial ACK: the segment at 3001 was lost too, and is retransmitted at once (NewReno)
+            sender.ack_received(WrappingInt32{1 + 3 * MSS}, 60000);
+            test_err_if(drain(sender) != vector<uint32_t>{1 + 3 * MSS},
+                        "a partial ACK should retransmit the next hole");
+            test_err_if(not sender.in_fast_recovery(), "a partial ACK should not end recovery");
+
+            sender.ack_received(WrappingInt32{1 + 8 * MSS}, 60000);
+            test_err_if(sender.in_fast_recovery(), "a full ACK should end recovery");
+            test_err_if(sender.congestion_control()->cwnd() != 7 * MSS / 2,
+                        "the window should be halved once per episode");
+            test_err_if(sender.consecutive_retransmissions() != 0, "fast retransmits are not timeouts");
+        }
+
+        {
+            // both sides send at once: the peer's data segments repeat its ackno, but are not duplicate ACKs
+            TCPConfig cfg;
+            cfg.fast_retransmit = true;
+            cfg.congestion_control = CongestionControl::Algorithm::Reno;
+            TCPConnection a{cfg};
+            TCPConnection b{cfg};
+            handshake(a, b);
+
+            a.write(string(3 * MSS, 'a'));
+            b.write(string(3 * MSS, 'b'));
+            const size_t a_sent = a.segments_out().size();
+            test_err_if(a_sent != 3 or b.segments_out().size() != 3, "each side should send three segments");
+
+            // all of b's data reaches a before any of a's data reaches b
+            while (not b.segments_out().empty()) {
+                a.segment_received(b.segments_out().front());
+                b.segments_out().pop();
+            }
+            for (size_t i = 0; i < a_sent; i++) {
+                a.segments_out().pop();
+            }
+            while (not a.segments_out().empty()) {
+                test_err_if(a.segments_out().front().length_in_sequence_space() != 0,
+                            "data segments from the peer should not trigger a fast retransmit");
+                a.segments_out().pop();
+            }
+            test_err_if(a.bytes_in_flight() != 3 * MSS, "nothing should have been retransmitted");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,68 @@
+#include "byte_stream.hh"
+#include "fsm_stream_reassembler_harness.hh"
+#include "stream_reassembler.hh"
+#include "util.hh"
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+int main() {
+    try {
+        for (const auto storage :
+             {ByteStream::Storage::Ring, ByteStream::Storage::BufferChain, ByteStream::Storage::MappedFile}) {
+            {
+                ReassemblerTestHarness test{16, storage};
+
+                test.execute(SubmitSegment{"abc", 0});
+                test.execute(PushesTaken(1, 0, 0));
+
+                // nothing staged: pushes at or before the next byte take the fast path
+                test.execute(SubmitSegment{"bcd", 1});
+                test.execute(PushesTaken(2, 0, 0));
+                test.execute(BytesAvailable("abcd"));
+
+                // bytes that were all assembled already are counted apart
+                test.execute(SubmitSegment{"ab", 0});
+                test.execute(PushesTaken(2, 0, 1));
+                test.execute(BytesAssembled(4));
+
+                // once bytes are staged, in-order pushes have to be merged with them
+                test.execute(SubmitSegment{"gh", 6});
+                test.execute(SubmitSegment{"e", 4});
+                test.execute(PushesTaken(2, 2, 1));
+                test.execute(BytesAssembled(5));
+                test.execute(SubmitSegment{"cd", 2});
+                test.execute(PushesTaken(2, 2, 2));
+                test.execute(SubmitSegment{"f", 5});
+                test.execute(PushesTaken(2, 3, 2));
+                test.execute(BytesAssembled(8));
+                test.execute(UnassembledBytes(0));
+
+                test.execute(SubmitSegment{"ij", 8});
+                test.execute(PushesTaken(3, 3, 2));
+                test.execute(BytesAvailable("efghij"));
+            }
+
+            {
+                ReassemblerTestHarness test{16, storage};
+
+                test.execute(SubmitBuffer{"ab", 0});
+                test.execute(SubmitBuffer{"d", 3});
+                test.execute(SubmitBuffer{"c", 2});
+                test.execute(PushesTaken(1, 2, 0));
+                test.execute(SubmitBuffer{"e", 4});
+                test.execute(PushesTaken(2, 2, 0));
+                test.execute(SubmitBuffer{"bc", 1});
+                test.execute(PushesTaken(2, 2, 1));
+                test.execute(BytesAvailable("abcde"));
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -103,6 +103,53 @@ struct UnassembledBytes : public ReassemblerExpectation {
     }
 };
 
+struct UnassembledRanges : public ReassemblerExpectation {
+    size_t _ranges;
+
+    UnassembledRanges(size_t ranges) : _ranges(ranges) {}
+    std::string description() const {
+        std::ostringstream ss;
+        ss << "ranges not assembled = " << _ranges;
+        return ss.str();
+    }
+
+    void execute(StreamReassembler &reassembler) const {
+        if (reassembler.unassembled_ranges().size() != _ranges) {
+            std::ostringstream ss;
+            ss << "The reassembler was expected to have `" << _ranges << "` ranges not assembled, but there were `"
+               << reassembler.unassembled_ranges().size() << "`";
+            throw ReassemblerExpectationViolation(ss.str());
+        }
+    }
+};
+
+struct PushesTaken : public ReassemblerExpectation {
+    uint64_t _fast_path;
+    uint64_t _slow_path;
+    uint64_t _duplicate;
+
+    PushesTaken(uint64_t fast_path, uint64_t slow_path, uint64_t duplicate)
+        : _fast_path(fast_path), _slow_path(slow_path), _duplicate(duplicate) {}
+    std::string description() const {
+        std::ostringstream ss;
+        ss << "fast-path pushes = " << _fast_path << ", slow-path pushes = " << _slow_path
+           << ", duplicate pushes = " << _duplicate;
+        return ss.str();
+    }
+
+    void execute(StreamReassembler &reassembler) const {
+        if (reassembler.fast_path_pushes() != _fast_path or reassembler.slow_path_pushes() != _slow_path or
+            reassembler.duplicate_pushes() != _duplicate) {
+            std::ostringstream ss;
+            ss << "The reassembler was expected to have counted `" << _fast_path << "` fast-path, `" << _slow_path
+               << "` slow-path and `" << _duplicate << "` duplicate pushes, but counted `"
+               << reassembler.fast_path_pushes() << "`, `" << reassembler.slow_path_pushes() << "` and `"
+               << reassembler.duplicate_pushes() << "`";
+            throw ReassemblerExpectationViolation(ss.str());
+        }
+    }
+};
+
 struct AtEof : public ReassemblerExpectation {
     AtEof() {}
     std::string description() const {
@@ -159,13 +206,34 @@ struct SubmitSegment : public ReassemblerAction {
     void execute(StreamReassembler &reassembler) const { reassembler.push_substring(_data, _index, _eof); }
 };
 
+//! Submits the substring through the Buffer overload, as TCPReceiver does
+struct SubmitBuffer : public SubmitSegment {
+    SubmitBuffer(std::string data, size_t index) : SubmitSegment(data, index) {}
+
+    SubmitBuffer &with_eof(bool eof) {
+        _eof = eof;
+        return *this;
+    }
+
+    std::string description() const { return "Buffer " + SubmitSegment::description(); }
+
+    void execute(StreamReassembler &reassembler) const {
+        reassembler.push_substring(Buffer(std::string(_data)), _index, _eof);
+    }
+};
+
 class ReassemblerTestHarness {
     StreamReassembler reassembler;
     std::vector<std::string> steps_executed;
 
   public:
-    ReassemblerTestHarness(const size_t capacity) : reassembler(capacity), steps_executed() {
-        steps_executed.emplace_back("Initialized (capacity = " + std::to_string(capacity) + ")");
+    ReassemblerTestHarness(const size_t capacity, const ByteStream::Storage storage = ByteStream::Storage::Ring)
+        : reassembler(capacity, storage), steps_executed() {
+        const std::string storage_name = storage == ByteStream::Storage::Ring          ? "Ring"
+                                         : storage == ByteStream::Storage::BufferChain ? "BufferChain"
+                                                                                       : "MappedFile";
+        steps_executed.emplace_back("Initialized (capacity = " + std::to_string(capacity) +
+                                    ", storage = " + storage_name + ")");
     }
 
     void execute(const ReassemblerTestStep &step) {
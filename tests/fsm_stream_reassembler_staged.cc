@@ -0,0 +1,110 @@
+#include "byte_stream.hh"
+#include "fsm_stream_reassembler_harness.hh"
+#include "stream_reassembler.hh"
+#include "util.hh"
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+int main() {
+    try {
+        // staged bytes sit in the stream's free space, so every storage mode must stage them the same way
+        for (const auto storage :
+             {ByteStream::Storage::Ring, ByteStream::Storage::BufferChain, ByteStream::Storage::MappedFile}) {
+            // staging across the wrap of the buffer
+            {
+                ReassemblerTestHarness test{8, storage};
+
+                test.execute(SubmitSegment{"abcde", 0});
+                test.execute(BytesAvailable("abcde"));
+
+                test.execute(SubmitSegment{"jkl", 9});
+                test.execute(SubmitSegment{"ghi", 6});
+                test.execute(BytesAssembled(5));
+                test.execute(UnassembledBytes(6));
+                test.execute(UnassembledRanges(1));
+
+                test.execute(SubmitSegment{"fghijklmnop", 5}.with_eof(true));
+                test.execute(BytesAssembled(13));
+                test.execute(UnassembledBytes(0));
+                test.execute(BytesAvailable("fghijklm"));
+                test.execute(NotAtEof{});
+
+                test.execute(SubmitSegment{"nop", 13}.with_eof(true));
+                test.execute(BytesAvailable("nop"));
+                test.execute(AtEof{});
+            }
+
+            // an in-order push that does not reach the staged bytes
+            {
+                ReassemblerTestHarness test{8, storage};
+
+                test.execute(SubmitSegment{"cd", 2});
+                test.execute(BytesAssembled(0));
+                test.execute(UnassembledBytes(2));
+
+                test.execute(SubmitSegment{"a", 0});
+                test.execute(BytesAssembled(1));
+                test.execute(UnassembledBytes(2));
+                test.execute(UnassembledRanges(1));
+
+                test.execute(SubmitSegment{"b", 1});
+                test.execute(BytesAssembled(4));
+                test.execute(UnassembledBytes(0));
+                test.execute(BytesAvailable("abcd"));
+            }
+
+            // an in-order push that joins up with the staged bytes
+            {
+                ReassemblerTestHarness test{8, storage};
+
+                test.execute(SubmitSegment{"ef", 4});
+                test.execute(SubmitSegment{"abcd", 0});
+                test.execute(BytesAssembled(6));
+                test.execute(UnassembledBytes(0));
+                test.execute(BytesAvailable("abcdef"));
+            }
+
+            // pushes that start before the next byte expected
+            {
+                ReassemblerTestHarness test{8, storage};
+
+                test.execute(SubmitSegment{"abc", 0});
+                test.execute(BytesAvailable("abc"));
+
+                test.execute(SubmitSegment{"bcdef", 1});
+                test.execute(BytesAssembled(6));
+                test.execute(BytesAvailable("def"));
+
+                test.execute(SubmitSegment{"h", 7});
+                test.execute(SubmitSegment{"efg", 4});
+                test.execute(BytesAssembled(8));
+                test.execute(UnassembledBytes(0));
+                test.execute(BytesAvailable("gh"));
+            }
+
+            // the same through the Buffer overload
+            {
+                ReassemblerTestHarness test{4, storage};
+
+                test.execute(SubmitBuffer{"cdef", 2}.with_eof(true));
+                test.execute(UnassembledBytes(2));
+
+                test.execute(SubmitBuffer{"abc", 0});
+                test.execute(BytesAvailable("abcd"));
+                test.execute(NotAtEof{});
+
+                test.execute(SubmitBuffer{"def", 3}.with_eof(true));
+                test.execute(BytesAvailable("ef"));
+                test.execute(AtEof{});
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
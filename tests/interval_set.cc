@@ -0,0 +1,52 @@
+#include "interval_set.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+static string describe(const IntervalSet &set) {
+    string result;
+    for (const auto &iv : set.intervals()) {
+        result += "[" + to_string(iv.begin) + "," + to_string(iv.end) + ")";
+    }
+    return result;
+}
+
+int main() {
+    try {
+        {
+            IntervalSet set;
+            set.insert(10, 20);
+            set.insert(30, 40);
+            set.insert(0, 5);
+            test_err_if(describe(set) != "[0,5)[10,20)[30,40)", "disjoint ranges should stay sorted: " + describe(set));
+            test_err_if(set.size() != 25, "size should count every index once");
+
+            set.insert(5, 10);
+            test_err_if(describe(set) != "[0,20)[30,40)", "touching ranges should merge: " + describe(set));
+            set.insert(15, 35);
+            test_err_if(describe(set) != "[0,40)", "overlapping ranges should merge: " + describe(set));
+            test_err_if(set.size() != 40, "size after merging");
+
+            set.insert(50, 60);
+            test_err_if(not set.contains(0) or not set.contains(39) or set.contains(40) or not set.contains(55),
+                        "contains() mismatch");
+            test_err_if(not set.covers(10, 40) or not set.covers(50, 60) or set.covers(35, 55) or not set.covers(7, 7),
+                        "covers() mismatch");
+
+            set.remove_prefix(25);
+            test_err_if(describe(set) != "[25,40)[50,60)", "remove_prefix should trim a range: " + describe(set));
+            set.remove_prefix(55);
+            test_err_if(describe(set) != "[55,60)", "remove_prefix should drop whole ranges: " + describe(set));
+            test_err_if(set.size() != 5, "size after remove_prefix");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,64 @@
+#include "rtt_estimator.hh"
+#include "tcp_config.hh"
+#include "tcp_sender.hh"
+#include "test_err_if.hh"
+
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        {
+            RTTEstimator rtt{1000, 200, 60000};
+            test_err_if(rtt.has_sample() or rtt.rto() != 1000, "RTO should start at the initial value");
+
+            rtt.sample(400);
+            test_err_if(rtt.srtt() != 400.0 or rtt.rttvar() != 200.0, "first sample sets SRTT = R, RTTVAR = R/2");
+            test_err_if(rtt.rto() != 1200, "RTO = SRTT + 4 * RTTVAR");
+
+            rtt.sample(200);
+            test_err_if(rtt.rttvar() != 0.75 * 200 + 0.25 * 200 or rtt.srtt() != 0.875 * 400 + 0.125 * 200,
+                        "later samples are smoothed, RTTVAR first");
+            test_err_if(rtt.min_rtt() != 200u or rtt.latest_rtt() != 200u, "latest/min sample accessors");
+
+            for (unsigned i = 0; i < 100; i++) {
+                rtt.sample(5);
+            }
+            test_err_if(rtt.rto() != 200, "RTO should be clamped to its minimum");
+            test_err_if(rtt.backed_off(40000) != 60000, "backoff should be clamped to the maximum");
+        }
+
+        {
+            TCPConfig cfg;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.adaptive_rto = true;
+            cfg.min_rto = 10;
+            TCPSender sender{cfg};
+
+            sender.fill_window();
+            sender.tick(30);
+            sender.ack_received(WrappingInt32{1}, 1000);
+            test_err_if(sender.rtt_estimator().latest_rtt() != 30u, "the SYN should be timed");
+
+            sender.stream_in().write("hello");
+            sender.fill_window();
+            test_err_if(sender.current_rto() != 30 + 4 * 15, "the timer should start from the computed RTO");
+
+            // a retransmitted segment must not produce a sample (Karn's algorithm)
+            sender.tick(90);
+            test_err_if(sender.current_rto() != 180, "the RTO should back off after a timeout");
+            sender.tick(500);
+            sender.ack_received(WrappingInt32{6}, 1000);
+            test_err_if(sender.rtt_estimator().latest_rtt() != 30u, "retransmitted segments must not be timed");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+#include "sender_harness.hh"
+#include "tcp_config.hh"
+#include "tcp_sender.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        constexpr uint32_t MSS = TCPConfig::MAX_PAYLOAD_SIZE;
+        const auto seg = [](const uint32_t n) { return WrappingInt32{1 + n * MSS}; };
+
+        TCPConfig cfg;
+        cfg.fixed_isn = WrappingInt32{0};
+        cfg.fast_retransmit = true;
+        cfg.sack = true;
+        cfg.congestion_control = CongestionControl::Algorithm::Reno;
+        TCPSenderTestHarness test{"SACK recovery", cfg};
+        const TCPSender &sender = test.tcp_sender();
+
+        test.execute(AckReceived{WrappingInt32{1}}.with_win(60000));
+        // one byte more than the initial window, since acknowledging the SYN grew it by one
+        test.execute(WriteBytes{string(10 * MSS + 1, 'x')});
+        test.execute(ExpectSegments{12});
+        test.execute(WriteBytes{string(4 * MSS, 'y')});
+        test.execute(ExpectNoSegment{});
+
+        // segments 0 and 3 are lost; every other segment arrives and is selectively acknowledged
+        test.execute(AckReceived{seg(0)}.with_win(60000).with_sack({{seg(1), seg(2)}}));
+        test.execute(AckReceived{seg(0)}.with_win(60000).with_sack({{seg(1), seg(3)}}));
+        // two duplicate ACKs do not trigger a retransmission
+        test.execute(ExpectNoSegment{});
+        test_err_if(sender.sacked_bytes() != 2 * MSS, "the scoreboard should hold both SACKed segments");
+
+        // the third duplicate ACK resends the hole
+        test.execute(AckReceived{seg(0)}.with_win(60000).with_sack({{seg(4), seg(5)}, {seg(1), seg(3)}}));
+        test.execute(ExpectSegment{}.with_seqno(seg(0)));
+        test.execute(ExpectNoSegment{});
+        test_err_if(not sender.in_fast_recovery() or sender.congestion_control()->cwnd() != 5 * MSS,
+                    "the window should be halved on entering recovery");
+
+        // segment 3 has only one SACKed segment above it, so it is not yet known to be lost;
+        // PRR holds back while the pipe is above ssthresh
+        test.execute(AckReceived{seg(0)}.with_win(60000).with_sack({{seg(4), seg(6)}, {seg(1), seg(3)}}));
+        test.execute(ExpectNoSegment{});
+
+        // with three SACKed segments above it, segment 3 is lost and resent without waiting for the RTO
+        test.execute(AckReceived{seg(0)}.with_win(60000).with_sack({{seg(4), seg(7)}, {seg(1), seg(3)}}));
+        test.execute(ExpectSegment{}.with_seqno(seg(3)));
+        test.execute(ExpectNoSegment{});
+        test_err_if(sender.sack_retransmits() != 1, "one selective retransmission");
+
+        // the pipe (two originals, the tiny segment and both retransmissions) is now 1 byte below ssthresh,
+        // so PRR sends just enough new data to bring it up to ssthresh, following the last segment sent
+        test.execute(AckReceived{seg(0)}.with_win(60000).with_sack({{seg(4), seg(8)}, {seg(1), seg(3)}}));
+        test.execute(ExpectSegment{}.with_seqno(seg(10) + 1).with_payload_size(MSS - 1));
+        test.execute(ExpectNoSegment{});
+
+        // each segment that leaves the network lets one more in
+        test.execute(AckReceived{seg(0)}.with_win(60000).with_sack({{seg(4), seg(9)}, {seg(1), seg(3)}}));
+        test.execute(ExpectSegment{}.with_payload_size(MSS));
+        test.execute(ExpectNoSegment{});
+
+        // blocks that cover data never sent are ignored, and deliver nothing
+        const uint64_t sacked = sender.sacked_bytes();
+        test.execute(AckReceived{seg(0)}.with_win(60000).with_sack({{seg(20), seg(21)}}));
+        test_err_if(sender.sacked_bytes() != sacked, "a SACK block beyond the next seqno should be ignored");
+        test.execute(ExpectNoSegment{});
+
+        // the retransmissions arrive: a partial ACK up to segment 3, then everything
+        test.execute(AckReceived{seg(3)}.with_win(60000));
+        test_err_if(not sender.in_fast_recovery() or sender.sacked_bytes() != 5 * MSS,
+                    "a partial ACK trims the scoreboard");
+        test.execute(AckReceived{sender.next_seqno()}.with_win(60000));
+        test_err_if(sender.in_fast_recovery(), "a full ACK should end recovery");
+        test_err_if(sender.congestion_control()->cwnd() != 5 * MSS, "recovery should leave the window at ssthresh");
+        test_err_if(sender.sacked_bytes() != 0 or sender.consecutive_retransmissions() != 0,
+                    "the scoreboard should be empty");
+        test_err_if(sender.fast_retransmits() != 1, "one recovery episode");
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
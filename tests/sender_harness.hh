@@ -115,6 +115,22 @@ struct ExpectNoSegment : public SenderExpectation {
     }
 };
 
+struct ExpectSegments : public SenderExpectation {
+    size_t _count;
+
+    ExpectSegments(size_t count) : _count(count) {}
+    std::string description() const { return std::to_string(_count) + " segments sent, and no more"; }
+
+    void execute(TCPSender &, std::queue<TCPSegment> &segments) const {
+        if (segments.size() != _count) {
+            std::ostringstream ss;
+            ss << "The TCPSender sent " << segments.size() << " segments, but was expected to send " << _count;
+            throw SenderExpectationViolation(ss.str());
+        }
+        segments = {};
+    }
+};
+
 struct SenderAction : public SenderTestStep {
     operator std::string() const { return "Action:      " + description(); }
     virtual std::string description() const { return "description missing"; }
@@ -191,11 +207,15 @@ struct Tick : public SenderAction {
 struct AckReceived : public SenderAction {
     WrappingInt32 _ackno;
     std::optional<uint16_t> _window_advertisement{};
+    std::vector<TCPHeader::SackBlock> _sack_blocks{};
 
     AckReceived(WrappingInt32 ackno) : _ackno(ackno) {}
     std::string description() const {
         std::ostringstream ss;
         ss << "ack " << _ackno.raw_value() << " winsize " << _window_advertisement.value_or(DEFAULT_TEST_WINDOW);
+        for (const auto &block : _sack_blocks) {
+            ss << " sack [" << block.left.raw_value() << "," << block.right.raw_value() << ")";
+        }
         return ss.str();
     }
 
@@ -204,8 +224,13 @@ struct AckReceived : public SenderAction {
         return *this;
     }
 
+    AckReceived &with_sack(std::vector<TCPHeader::SackBlock> sack_blocks) {
+        _sack_blocks = std::move(sack_blocks);
+        return *this;
+    }
+
     void execute(TCPSender &sender, std::queue<TCPSegment> &) const {
-        sender.ack_received(_ackno, _window_advertisement.value_or(DEFAULT_TEST_WINDOW));
+        sender.ack_received(_ackno, _window_advertisement.value_or(DEFAULT_TEST_WINDOW), _sack_blocks);
         sender.fill_window();
     }
 };
@@ -394,7 +419,7 @@ class TCPSenderTestHarness {
   public:
     TCPSenderTestHarness(const std::string &name_, TCPConfig config)
         : outbound_segments()
-        , sender(config.send_capacity, config.rt_timeout, config.fixed_isn)
+        , sender(config)
         , steps_executed()
         , name(name_) {
         sender.fill_window();
@@ -405,6 +430,9 @@ class TCPSenderTestHarness {
         steps_executed.emplace_back(ss.str());
     }
 
+    //! The sender under test, for checks of state that no expectation covers
+    const TCPSender &tcp_sender() const { return sender; }
+
     void execute(const SenderTestStep &step) {
         try {
             step.execute(sender, outbound_segments);
@@ -0,0 +1,57 @@
+#include "tcp_config.hh"
+#include "tcp_sender.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        constexpr size_t MSS = TCPConfig::MAX_PAYLOAD_SIZE;
+
+        TCPConfig cfg;
+        cfg.fixed_isn = WrappingInt32{0};
+        TCPSender sender{cfg};
+        test_err_if(sender.stream_in().storage() != ByteStream::Storage::BufferChain,
+                    "the outgoing stream should keep its bytes as shared Buffers");
+
+        sender.fill_window();
+        sender.segments_out().pop();
+        sender.ack_received(WrappingInt32{1}, 10 * MSS);
+
+        const Buffer written{string(3 * MSS + 10, 'x')};
+        sender.stream_in().write(written);
+        sender.fill_window();
+
+        // every segment's payload is a slice of the written Buffer
+        test_err_if(sender.segments_out().size() != 4, "the bytes should be cut into four segments");
+        const char *expected = written.str().data();
+        while (not sender.segments_out().empty()) {
+            const Buffer &payload = sender.segments_out().front().payload();
+            test_err_if(payload.str().data() != expected, "a segment's payload should share the written bytes");
+            expected += payload.size();
+            sender.segments_out().pop();
+        }
+
+        // a retransmission resends the same retained bytes
+        sender.tick(cfg.rt_timeout);
+        test_err_if(sender.segments_out().size() != 1, "the RTO should resend the oldest segment");
+        test_err_if(sender.segments_out().front().payload().str().data() != written.str().data(),
+                    "a retransmission should reuse the retained bytes");
+        sender.segments_out().pop();
+
+        // a spilling stream still works, copying the bytes
+        cfg.spill_threshold = 1000;
+        TCPSender spilling{cfg};
+        test_err_if(spilling.stream_in().storage() != ByteStream::Storage::MappedFile,
+                    "a large send buffer should spill");
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
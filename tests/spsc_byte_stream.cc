@@ -0,0 +1,82 @@
+#include "spsc_byte_stream.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+int main() {
+    try {
+        {
+            SPSCByteStream stream{4};
+            test_err_if(stream.write("cat") != 3, "write should accept 3 bytes");
+            test_err_if(stream.remaining_capacity() != 1, "remaining capacity should be 1");
+            test_err_if(stream.read(2) != "ca", "read should return the first two bytes");
+            test_err_if(stream.write("dogs") != 3, "write should wrap around the ring");
+            test_err_if(stream.peek_output(4) != "tdog", "peek should see across the wrap");
+            const auto [first, second] = stream.peek_spans(4);
+            test_err_if(first != "td" or second != "og", "peek_spans should split at the wrap");
+            stream.end_input();
+            test_err_if(stream.write("x") != 0, "write after end_input should be refused");
+            stream.pop_output(4);
+            test_err_if(not stream.eof(), "stream should be at eof");
+            test_err_if(stream.bytes_written() != 6 or stream.bytes_read() != 6, "accounting mismatch");
+        }
+
+        {
+            // one producer and one consumer thread stream bytes through a small ring
+            constexpr size_t total = 4 * 1024 * 1024;
+            SPSCByteStream stream{1000};
+
+            thread producer([&] {
+                string chunk;
+                size_t sent = 0;
+                while (sent < total) {
+                    chunk.clear();
+                    for (size_t i = 0; i < 777 and sent + i < total; i++) {
+                        chunk.push_back(static_cast<char>((sent + i) % 251));
+                    }
+                    size_t offset = 0;
+                    while (offset < chunk.size()) {
+                        stream.wait_writable(1);
+                        offset += stream.write(chunk.substr(offset));
+                    }
+                    sent += chunk.size();
+                }
+                stream.end_input();
+            });
+
+            size_t received = 0;
+            bool in_order = true;
+            while (not stream.eof()) {
+                stream.wait_readable();
+                for (const char c : stream.read(512)) {
+                    in_order &= (c == static_cast<char>(received % 251));
+                    received++;
+                }
+            }
+            producer.join();
+
+            test_err_if(not in_order, "consumer saw bytes out of order");
+            test_err_if(received != total,
+                        "consumer saw " + to_string(received) + " bytes, expected " + to_string(total));
+            test_err_if(stream.bytes_read() != total or stream.bytes_written() != total, "accounting mismatch");
+        }
+
+        {
+            SPSCByteStream stream{8};
+            const auto deadline = SPSCByteStream::Clock::now() + chrono::milliseconds(10);
+            test_err_if(stream.wait_readable(deadline), "empty stream should time out waiting to read");
+            stream.set_error();
+            test_err_if(not stream.wait_readable(), "errored stream should count as readable");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
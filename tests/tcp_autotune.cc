@@ -0,0 +1,186 @@
+#include "byte_stream.hh"
+#include "tcp_config.hh"
+#include "tcp_connection.hh"
+#include "tcp_connection_test_helpers.hh"
+#include "test_err_if.hh"
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        for (const auto storage :
+             {ByteStream::Storage::Ring, ByteStream::Storage::BufferChain, ByteStream::Storage::MappedFile}) {
+            // unread bytes that wrap around the ring, and staged bytes after them, survive growing and shrinking
+            ByteStream stream{8, storage};
+            stream.write("abcdef");
+            stream.pop_output(4);
+            stream.write("ghij");
+            stream.stage(1, "l");
+            stream.set_capacity(16);
+            test_err_if(stream.capacity() != 16 or stream.remaining_capacity() != 10, "the stream should have grown");
+            stream.stage(0, "k");
+            stream.commit(2);
+            stream.write("mnop");
+            test_err_if(stream.read(100) != "efghijklmnop", "the bytes should survive growing the stream");
+
+            stream.write("qrstuv");
+            stream.stage(0, "w");
+            stream.set_capacity(7);
+            stream.commit(1);
+            test_err_if(stream.remaining_capacity() != 0, "the stream should have shrunk");
+            test_err_if(stream.read(100) != "qrstuvw", "the bytes should survive shrinking the stream");
+
+            stream.write("xyz");
+            bool threw = false;
+            try {
+                stream.set_capacity(2);
+            } catch (const invalid_argument &) {
+                threw = true;
+            }
+            test_err_if(not threw, "the stream cannot shrink below the bytes it holds");
+        }
+
+        {
+            TCPConfig cfg;
+            cfg.autotune_buffers = true;
+            cfg.window_scaling = true;
+            cfg.congestion_control = CongestionControl::Algorithm::Reno;
+            TCPConnection client{cfg};
+            TCPConnection server{cfg};
+
+            // a 50 ms round trip, seen by both sides during the handshake
+            client.connect();
+            server.segment_received(pop_segment(client));
+            client.tick(50);
+            client.segment_received(pop_segment(server));
+            server.tick(50);
+            exchange(client, server);
+
+            // an application that reads everything as soon as it arrives, behind a sender that keeps up
+            size_t total_read = 0;
+            for (unsigned round = 0; round < 6; round++) {
+                client.write(string(client.remaining_outbound_capacity(), 'x'));
+                exchange(client, server);
+                total_read += server.inbound_stream().read(server.inbound_stream().buffer_size()).size();
+                client.tick(50);
+                server.tick(50);
+                exchange(client, server);
+            }
+            test_err_if(server.inbound_stream().capacity() <= 4 * TCPConfig::DEFAULT_CAPACITY,
+                        "the receive buffer should grow with what the application reads per RTT");
+            test_err_if(total_read <= 6 * TCPConfig::DEFAULT_CAPACITY, "a larger window should carry more per RTT");
+            test_err_if(server.inbound_stream().capacity() > cfg.max_recv_capacity, "the cap should hold");
+            test_err_if(client.remaining_outbound_capacity() + client.bytes_in_flight() <= TCPConfig::DEFAULT_CAPACITY,
+                        "the send buffer should grow with the sending window");
+
+            // idle connections give the memory back
+            total_read += server.inbound_stream().read(server.inbound_stream().buffer_size()).size();
+            for (unsigned ms = 0; ms < 2 * TCPConfig::TIMEOUT_DFLT; ms += 50) {
+                client.tick(50);
+                server.tick(50);
+                exchange(client, server);
+                server.inbound_stream().pop_output(server.inbound_stream().buffer_size());
+            }
+            test_err_if(client.remaining_outbound_capacity() != TCPConfig::DEFAULT_CAPACITY,
+                        "an idle send buffer should shrink back");
+            const size_t grown = server.inbound_stream().capacity();
+            test_err_if(grown <= TCPConfig::DEFAULT_CAPACITY, "the window already offered should not be retracted");
+
+            // the peer may still send everything the window it was last offered allows
+            size_t sent = 0;
+            while (true) {
+                client.write(string(client.remaining_outbound_capacity(), 'y'));
+                if (client.segments_out().empty()) {
+                    break;
+                }
+                while (not client.segments_out().empty()) {
+                    const TCPSegment seg = pop_segment(client);
+                    sent += seg.payload().size();
+                    server.segment_received(seg);
+                }
+            }
+            test_err_if(sent <= TCPConfig::DEFAULT_CAPACITY,
+                        "the peer should send more than the shrunken buffer holds");
+            test_err_if(server.inbound_stream().buffer_size() != sent,
+                        "data sent into the offered window must be kept");
+
+            // once that data is read, the window advertised next fits the smaller buffer
+            server.inbound_stream().pop_output(sent);
+            server.tick(1);
+            exchange(client, server);
+            test_err_if(server.inbound_stream().capacity() != TCPConfig::DEFAULT_CAPACITY,
+                        "the receive buffer should shrink back once the offered window is used up");
+        }
+
+        {
+            // a host that wakes only when the earliest next_timeout() comes due still sees the buffers autotuned
+            TCPConfig cfg;
+            cfg.autotune_buffers = true;
+            cfg.window_scaling = true;
+            cfg.congestion_control = CongestionControl::Algorithm::Reno;
+            TCPConnection client{cfg};
+            TCPConnection server{cfg};
+
+            client.connect();
+            server.segment_received(pop_segment(client));
+            client.tick(50);
+            client.segment_received(pop_segment(server));
+            server.tick(50);
+            exchange(client, server);
+
+            // \returns the milliseconds that passed, or nothing if neither connection has a deadline
+            const auto wake = [&]() -> optional<size_t> {
+                const size_t ms =
+                    min(client.next_timeout().value_or(SIZE_MAX), server.next_timeout().value_or(SIZE_MAX));
+                if (ms == SIZE_MAX) {
+                    return {};
+                }
+                client.tick(ms);
+                server.tick(ms);
+                exchange(client, server);
+                return ms;
+            };
+
+            for (unsigned round = 0; round < 6; round++) {
+                client.write(string(client.remaining_outbound_capacity(), 'x'));
+                exchange(client, server);
+                server.inbound_stream().pop_output(server.inbound_stream().buffer_size());
+                // until the next round trip, or until everything is delivered and read
+                size_t elapsed = 0;
+                while (elapsed < 50) {
+                    const optional<size_t> ms = wake();
+                    if (not ms.has_value()) {
+                        break;
+                    }
+                    elapsed += ms.value();
+                }
+            }
+            test_err_if(server.inbound_stream().capacity() <= TCPConfig::DEFAULT_CAPACITY,
+                        "the receive buffer should grow without a tick every few milliseconds");
+
+            // the application keeps reading until the connection goes quiet
+            for (unsigned wakeups = 0; wakeups < 1000; wakeups++) {
+                server.inbound_stream().pop_output(server.inbound_stream().buffer_size());
+                if (not wake().has_value()) {
+                    break;
+                }
+            }
+            test_err_if(client.remaining_outbound_capacity() != TCPConfig::DEFAULT_CAPACITY,
+                        "the idle send buffer should shrink back without a tick every few milliseconds");
+            test_err_if(client.next_timeout().has_value() or server.next_timeout().has_value(),
+                        "an idle connection should not ask to be woken");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
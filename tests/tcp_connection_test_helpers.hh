@@ -0,0 +1,44 @@
+#ifndef SPONGE_TESTS_TCP_CONNECTION_TEST_HELPERS_HH
+#define SPONGE_TESTS_TCP_CONNECTION_TEST_HELPERS_HH
+
+#include "tcp_connection.hh"
+#include "tcp_segment.hh"
+
+#include <stdexcept>
+
+//! \file
+//! Helpers for tests that drive TCPConnection objects directly, handing segments from one to the other
+//! without a network in between
+
+//! Take the next segment `conn` has queued
+//! \throws std::runtime_error if there is none
+inline TCPSegment pop_segment(TCPConnection &conn) {
+    if (conn.segments_out().empty()) {
+        throw std::runtime_error("expected a segment");
+    }
+    TCPSegment seg = conn.segments_out().front();
+    conn.segments_out().pop();
+    return seg;
+}
+
+//! Open a connection from `client` to `server`: deliver the SYN, the SYN/ACK and the final ACK in turn
+inline void handshake(TCPConnection &client, TCPConnection &server) {
+    client.connect();
+    server.segment_received(pop_segment(client));
+    client.segment_received(pop_segment(server));
+    server.segment_received(pop_segment(client));
+}
+
+//! Deliver segments both ways until neither side has anything more to send
+inline void exchange(TCPConnection &a, TCPConnection &b) {
+    while (not a.segments_out().empty() or not b.segments_out().empty()) {
+        while (not a.segments_out().empty()) {
+            b.segment_received(pop_segment(a));
+        }
+        while (not b.segments_out().empty()) {
+            a.segment_received(pop_segment(b));
+        }
+    }
+}
+
+#endif  // SPONGE_TESTS_TCP_CONNECTION_TEST_HELPERS_HH
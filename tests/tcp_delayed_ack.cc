@@ -0,0 +1,94 @@
+#include "tcp_config.hh"
+#include "tcp_connection.hh"
+#include "tcp_connection_test_helpers.hh"
+#include "tcp_segment.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        TCPConfig server_cfg;
+        server_cfg.delayed_ack = true;
+        TCPConnection client{TCPConfig{}};
+        TCPConnection server{server_cfg};
+
+        handshake(client, server);
+        test_err_if(not server.segments_out().empty(), "the handshake's ACK needs no answer");
+
+        {
+            // a lone segment is ACKed when the delay runs out
+            client.write(string(1000, 'a'));
+            const TCPSegment data = pop_segment(client);
+            server.segment_received(data);
+            test_err_if(not server.segments_out().empty(), "the ACK should be delayed");
+            test_err_if(server.next_timeout() != optional<size_t>{TCPConfig::DELAYED_ACK_DFLT},
+                        "the delayed ACK should be the next deadline");
+            server.tick(TCPConfig::DELAYED_ACK_DFLT - 1);
+            test_err_if(not server.segments_out().empty(), "the ACK is not due yet");
+            server.tick(1);
+            test_err_if(pop_segment(server).header().ackno != data.header().seqno + 1000,
+                        "the delayed ACK should go out");
+            test_err_if(server.next_timeout().has_value(), "nothing is left to ACK");
+        }
+
+        {
+            // every second full-sized segment is ACKed at once
+            client.write(string(2000, 'b'));
+            const TCPSegment first = pop_segment(client);
+            const TCPSegment second = pop_segment(client);
+            server.segment_received(first);
+            test_err_if(not server.segments_out().empty(), "the first segment's ACK should be delayed");
+            server.segment_received(second);
+            test_err_if(pop_segment(server).header().ackno != second.header().seqno + 1000,
+                        "the second segment should be ACKed at once");
+            test_err_if(server.next_timeout().has_value(), "one ACK should cover both segments");
+        }
+
+        {
+            // out-of-order data is ACKed at once, and so is the segment that fills the hole
+            client.write(string(2000, 'c'));
+            const TCPSegment first = pop_segment(client);
+            const TCPSegment second = pop_segment(client);
+            server.segment_received(second);
+            test_err_if(pop_segment(server).header().ackno != first.header().seqno,
+                        "out-of-order data needs a dup ACK");
+            server.segment_received(first);
+            test_err_if(pop_segment(server).header().ackno != second.header().seqno + 1000,
+                        "the segment filling the hole should be ACKed at once");
+        }
+
+        {
+            // data the server answers with data of its own carries the ACK
+            client.write(string(100, 'd'));
+            const TCPSegment data = pop_segment(client);
+            server.segment_received(data);
+            test_err_if(not server.segments_out().empty(), "the ACK should be delayed");
+            server.write("reply");
+            const TCPSegment reply = pop_segment(server);
+            test_err_if(not reply.header().ack or reply.header().ackno != data.header().seqno + 100,
+                        "the reply should carry the ACK");
+            test_err_if(server.next_timeout() != optional<size_t>{TCPConfig::TIMEOUT_DFLT},
+                        "only the reply's retransmission timer should be left");
+            client.segment_received(reply);
+            pop_segment(client);
+        }
+
+        {
+            // a FIN is ACKed at once
+            client.end_input_stream();
+            const TCPSegment fin = pop_segment(client);
+            server.segment_received(fin);
+            test_err_if(pop_segment(server).header().ackno != fin.header().seqno + 1, "a FIN should be ACKed at once");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
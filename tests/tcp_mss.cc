@@ -0,0 +1,116 @@
+#include "fd_adapter.hh"
+#include "network_interface.hh"
+#include "tcp_config.hh"
+#include "tcp_connection.hh"
+#include "tcp_connection_test_helpers.hh"
+#include "tcp_header.hh"
+#include "tcp_over_ip.hh"
+#include "tcp_segment.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+//! \returns the payload sizes of the queued segments, emptying the queue
+static vector<size_t> drain_payloads(TCPConnection &conn) {
+    vector<size_t> sizes;
+    while (not conn.segments_out().empty()) {
+        sizes.push_back(pop_segment(conn).payload().size());
+    }
+    return sizes;
+}
+
+int main() {
+    try {
+        {
+            // the option survives serializing and parsing, next to SACK-permitted
+            TCPSegment seg;
+            seg.header().syn = true;
+            seg.header().mss = 8960;
+            seg.header().sack_permitted = true;
+            test_err_if(seg.header().length() != TCPHeader::LENGTH + 8, "MSS and SACK-permitted take two words");
+
+            TCPSegment parsed;
+            test_err_if(parsed.parse(seg.serialize().concatenate()) != ParseResult::NoError, "parse failed");
+            test_err_if(parsed.header().mss != optional<uint16_t>{8960}, "MSS option was lost");
+            test_err_if(not parsed.header().sack_permitted, "SACK-permitted was lost");
+        }
+
+        {
+            // a jumbo-frame client talks to a server with a smaller MSS: both sides send the smaller size
+            TCPConfig client_cfg;
+            client_cfg.mss = 8960;
+            client_cfg.send_capacity = client_cfg.recv_capacity = 100000;
+            TCPConfig server_cfg = client_cfg;
+            server_cfg.mss = 4000;
+            TCPConnection client{client_cfg};
+            TCPConnection server{server_cfg};
+
+            client.connect();
+            const TCPSegment syn = pop_segment(client);
+            test_err_if(syn.header().mss != optional<uint16_t>{8960}, "the SYN should offer the configured MSS");
+            server.segment_received(syn);
+            const TCPSegment syn_ack = pop_segment(server);
+            test_err_if(syn_ack.header().mss != optional<uint16_t>{4000}, "the SYN/ACK should offer the server's MSS");
+            client.segment_received(syn_ack);
+            server.segment_received(pop_segment(client));
+
+            client.write(string(10000, 'x'));
+            test_err_if(drain_payloads(client) != vector<size_t>({4000, 4000, 2000}),
+                        "the server's offer should limit the client");
+            server.write(string(10000, 'y'));
+            test_err_if(drain_payloads(server) != vector<size_t>({4000, 4000, 2000}),
+                        "the server's own MSS should limit it");
+        }
+
+        {
+            // without an MSS option from the peer, the sender stays at the conservative default
+            TCPConfig cfg;
+            cfg.mss = 8960;
+            TCPConnection conn{cfg};
+            conn.connect();
+            TCPSegment syn_ack = pop_segment(conn);
+            syn_ack.header().ackno = syn_ack.header().seqno + 1;
+            syn_ack.header().seqno = WrappingInt32{0};
+            syn_ack.header().ack = true;
+            syn_ack.header().win = 10000;
+            syn_ack.header().mss.reset();
+            conn.segment_received(syn_ack);
+            pop_segment(conn);
+            conn.write(string(3000, 'z'));
+            test_err_if(drain_payloads(conn) != vector<size_t>(3, TCPConfig::MAX_PAYLOAD_SIZE),
+                        "segments should fall back to MAX_PAYLOAD_SIZE");
+        }
+
+        {
+            // the interface drops datagrams bigger than its MTU instead of sending oversized frames
+            NetworkInterface iface{{2, 0, 0, 0, 0, 1}, Address{"10.0.0.1", 0}, 1500};
+            InternetDatagram dgram;
+            dgram.header().len = 1501;
+            iface.send_datagram(dgram, Address{"10.0.0.2", 0});
+            test_err_if(not iface.frames_out().empty(), "an oversized datagram should be dropped");
+            dgram.header().len = 1500;
+            iface.send_datagram(dgram, Address{"10.0.0.2", 0});
+            test_err_if(iface.frames_out().size() != 1, "a datagram that fits should trigger an ARP request");
+        }
+
+        {
+            // a full segment, wrapped in TCP, UDP and IPv4 headers, fits the MTU of the link it crosses
+            TCPOverUDPSocketAdapter udp{UDPSocket{}};
+            udp.config_mut().mtu = 1500;
+            test_err_if(udp.max_segment_size() != 1500 - 20 - 8 - 20,
+                        "the UDP adapter should leave room for its headers");
+            TCPOverIPv4Adapter ip;
+            ip.config_mut().mtu = 1500;
+            test_err_if(ip.max_segment_size() != 1500 - 20 - 20, "the IPv4 adapter should leave room for its headers");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+#include "sender_harness.hh"
+#include "tcp_config.hh"
+#include "tcp_sender.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        for (const bool pacing : {false, true}) {
+            TCPConfig cfg;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.congestion_control = CongestionControl::Algorithm::Reno;
+            cfg.send_capacity = 100'000;
+            cfg.pacing = pacing;
+            TCPSenderTestHarness test{pacing ? "pacing" : "no pacing", cfg};
+            const TCPSender &sender = test.tcp_sender();
+
+            // a handshake that took 100 ms, so that the sender has an SRTT to pace with
+            test.execute(Tick{100});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(60'000));
+            test.execute(ExpectSegments{1});
+            const uint64_t cwnd = sender.congestion_control()->cwnd();
+
+            if (not pacing) {
+                test_err_if(sender.pacing_rate() != 0, "pacing is off by default");
+                test.execute(WriteBytes{string(20'000, 'x')});
+                test_err_if(sender.bytes_in_flight() != cwnd,
+                            "without pacing, the whole congestion window goes out at once");
+                test_err_if(sender.next_send_delay().has_value(), "nothing waits for pacing");
+                continue;
+            }
+
+            // slow start: twice the congestion window (about 10 * 1000 bytes) per 100 ms round trip
+            test_err_if(sender.pacing_rate() != 2 * cwnd * 1000 / 100,
+                        "the rate should be 2 * cwnd / SRTT in slow start");
+
+            // the bucket starts with two segments' worth of tokens
+            test.execute(WriteBytes{string(20'000, 'x')});
+            test.execute(ExpectSegments{2});
+            test_err_if(sender.next_send_delay() != optional<size_t>{1},
+                        "the next segment is due as soon as time passes");
+
+            // about 200 bytes per millisecond: one 1000-byte segment every 4 or 5 ms
+            test.execute(Tick{1});
+            test.execute(ExpectSegments{1});
+            test_err_if(sender.next_send_delay() != optional<size_t>{4}, "the overdraft takes 4 ms to pay back");
+            for (unsigned ms = 0; ms < 20; ms++) {
+                test.execute(Tick{1});
+            }
+            test.execute(ExpectSegments{4});
+
+            // the congestion window still caps what is in flight
+            for (unsigned ms = 0; ms < 50; ms++) {
+                test.execute(Tick{1});
+            }
+            test_err_if(sender.bytes_in_flight() != cwnd, "pacing should not let more than cwnd be in flight");
+            test_err_if(sender.next_send_delay().has_value(), "a segment held back by the window is not due");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
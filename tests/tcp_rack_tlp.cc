@@ -0,0 +1,83 @@
+#include "sender_harness.hh"
+#include "tcp_config.hh"
+#include "tcp_header.hh"
+#include "tcp_sender.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        TCPConfig cfg;
+        cfg.fixed_isn = WrappingInt32{0};
+        cfg.congestion_control = CongestionControl::Algorithm::Reno;
+        cfg.send_capacity = 100'000;
+        cfg.rack_tlp = true;
+
+        {
+            // the whole flight is lost: a probe goes out after 2 * SRTT, long before the 1 s RTO
+            TCPSenderTestHarness test{"tail loss probe", cfg};
+            const TCPSender &sender = test.tcp_sender();
+            // a handshake that took 100 ms, so that SRTT and the minimum RTT are 100 ms
+            test.execute(Tick{100});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(60'000));
+            test.execute(ExpectSegments{1});
+
+            test.execute(WriteBytes{string(10'000, 'x')});
+            test.execute(ExpectSegments{10});
+            test_err_if(sender.next_timeout() != optional<size_t>{201}, "the probe timeout should be 2 * SRTT");
+
+            test.execute(Tick{200});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test_err_if(sender.tail_loss_probes() != 1, "the probe timeout should send a probe");
+            // the probe resends the last segment
+            test.execute(ExpectSegment{}.with_seqno(9001).with_payload_size(1000));
+            test.execute(ExpectNoSegment{});
+            test_err_if(sender.consecutive_retransmissions() != 0, "a probe is not a retransmission timeout");
+
+            // the probe's ACK covers everything: without DSACK the tail counts as lost
+            test.execute(Tick{100});
+            test.execute(AckReceived{WrappingInt32{10'001}}.with_win(60'000));
+            test_err_if(sender.congestion_control()->cwnd() != 5000, "a repaired tail should halve the window");
+        }
+
+        {
+            // five segments, then a sixth 10 ms later; only the sixth arrives
+            TCPSenderTestHarness test{"reordering timer", cfg};
+            const TCPSender &sender = test.tcp_sender();
+            test.execute(Tick{100});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(60'000));
+            test.execute(ExpectSegments{1});
+
+            test.execute(WriteBytes{string(5000, 'x')});
+            test.execute(Tick{10});
+            test.execute(WriteBytes{string(1000, 'x')});
+            test.execute(ExpectSegments{6});
+
+            test.execute(Tick{100});
+            test.execute(
+                AckReceived{WrappingInt32{1}}.with_win(60'000).with_sack({{WrappingInt32{5001}, WrappingInt32{6001}}}));
+            test_err_if(sender.fast_retransmits() != 0, "one SACKed segment is too few for the duplicate ACK rule");
+            // the earlier segments get one RTT plus a quarter of the minimum RTT to arrive
+            test_err_if(sender.next_timeout() != optional<size_t>{15}, "the reordering timer should be armed");
+
+            test.execute(Tick{14});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test_err_if(sender.fast_retransmits() != 1, "the reordering timer should start recovery");
+            // the first segment is resent first
+            test.execute(ExpectSegment{}.with_seqno(1));
+            test_err_if(sender.sack_retransmits() < 1, "the lost segments should be resent from the scoreboard");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,79 @@
+#include "tcp_config.hh"
+#include "tcp_connection.hh"
+#include "tcp_connection_test_helpers.hh"
+#include "tcp_header.hh"
+#include "tcp_segment.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+static TCPSegment make_segment(const WrappingInt32 seqno, const WrappingInt32 ackno, const string &payload) {
+    TCPSegment seg;
+    seg.header().seqno = seqno;
+    seg.header().ackno = ackno;
+    seg.header().ack = true;
+    seg.header().win = 1000;
+    seg.payload() = Buffer(string(payload));
+    return seg;
+}
+
+int main() {
+    try {
+        {
+            // options survive serializing and parsing
+            TCPSegment seg;
+            seg.header().syn = true;
+            seg.header().sack_permitted = true;
+            seg.header().sack_blocks = {{WrappingInt32{100}, WrappingInt32{200}}, {WrappingInt32{300}, WrappingInt32{400}}};
+            seg.payload() = Buffer(string("hello"));
+            test_err_if(seg.header().length() != TCPHeader::LENGTH + 24, "options should be padded to whole words");
+
+            TCPSegment parsed;
+            test_err_if(parsed.parse(seg.serialize().concatenate()) != ParseResult::NoError, "parse failed");
+            test_err_if(not parsed.header().sack_permitted, "SACK-permitted was lost");
+            test_err_if(parsed.header().sack_blocks != seg.header().sack_blocks, "SACK blocks were lost");
+            test_err_if(parsed.header().doff != 11, "doff should cover the options");
+            test_err_if(parsed.payload().copy() != "hello", "payload was corrupted by the options");
+        }
+
+        for (const bool peer_offers_sack : {true, false}) {
+            const WrappingInt32 tx_isn{1000};
+            const WrappingInt32 rx_isn{5000};
+            TCPConfig cfg;
+            cfg.fixed_isn = tx_isn;
+            cfg.sack = true;
+            TCPConnection conn{cfg};
+
+            conn.connect();
+            test_err_if(not pop_segment(conn).header().sack_permitted, "SYN should offer SACK");
+
+            TCPSegment syn_ack = make_segment(rx_isn, tx_isn + 1, "");
+            syn_ack.header().syn = true;
+            syn_ack.header().sack_permitted = peer_offers_sack;
+            conn.segment_received(syn_ack);
+            test_err_if(not pop_segment(conn).header().sack_blocks.empty(), "nothing out of order yet");
+
+            // bytes 10..15 and 20..25 arrive; 0..9 and 16..19 are missing
+            conn.segment_received(make_segment(rx_isn + 11, tx_isn + 1, "abcde"));
+            pop_segment(conn);
+            conn.segment_received(make_segment(rx_isn + 21, tx_isn + 1, "fghij"));
+            const TCPHeader ack = pop_segment(conn).header();
+            test_err_if(ack.ackno != rx_isn + 1, "ackno should not move past the hole");
+            if (peer_offers_sack) {
+                const vector<TCPHeader::SackBlock> expected{{rx_isn + 21, rx_isn + 26}, {rx_isn + 11, rx_isn + 16}};
+                test_err_if(ack.sack_blocks != expected, "ACK should report both blocks, newest first");
+            } else {
+                test_err_if(not ack.sack_blocks.empty(), "SACK must not be sent unless the peer offered it");
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
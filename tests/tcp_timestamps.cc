@@ -0,0 +1,132 @@
+#include "tcp_config.hh"
+#include "tcp_connection.hh"
+#include "tcp_connection_test_helpers.hh"
+#include "tcp_header.hh"
+#include "tcp_segment.hh"
+#include "tcp_sender.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        {
+            // the option survives serializing and parsing, and leaves room for only three SACK blocks
+            TCPSegment seg;
+            seg.header().ack = true;
+            seg.header().timestamps = TCPHeader::Timestamps{0x12345678, 0x9abcdef0};
+            for (uint32_t i = 0; i < 4; i++) {
+                seg.header().sack_blocks.push_back({WrappingInt32{100 * i + 10}, WrappingInt32{100 * i + 20}});
+            }
+            test_err_if(seg.header().length() != TCPHeader::LENGTH + 12 + 4 + 3 * 8, "timestamps and 3 SACK blocks");
+
+            TCPSegment parsed;
+            test_err_if(parsed.parse(seg.serialize().concatenate()) != ParseResult::NoError, "parse failed");
+            test_err_if(not (parsed.header().timestamps == seg.header().timestamps), "timestamps option was lost");
+            test_err_if(parsed.header().sack_blocks.size() != TCPHeader::MAX_SACK_BLOCKS_WITH_TIMESTAMPS,
+                        "only three SACK blocks fit next to timestamps");
+        }
+
+        {
+            // every ACK of new data echoes a timestamp, so retransmitted segments are timed too
+            TCPConfig cfg;
+            cfg.fixed_isn = WrappingInt32{0};
+            TCPSender sender{cfg};
+
+            sender.fill_window();
+            sender.tick(10);
+            sender.ack_received(WrappingInt32{1}, 1000, {}, 0);
+            test_err_if(sender.rtt_estimator().latest_rtt() != 10u, "the SYN's echo should give a sample");
+
+            sender.stream_in().write("hello");
+            sender.fill_window();
+            sender.tick(1000);
+            test_err_if(sender.consecutive_retransmissions() != 1, "the segment should have been retransmitted");
+            const uint32_t retransmitted_at = sender.timestamp();
+            sender.tick(40);
+            sender.ack_received(WrappingInt32{6}, 1000, {}, retransmitted_at);
+            test_err_if(sender.rtt_estimator().latest_rtt() != 40u, "the retransmission should be timed by its echo");
+
+            sender.tick(25);
+            sender.ack_received(WrappingInt32{6}, 1000, {}, retransmitted_at);
+            test_err_if(sender.rtt_estimator().latest_rtt() != 40u, "an ACK of no new data gives no sample");
+        }
+
+        for (const bool server_timestamps : {true, false}) {
+            TCPConfig client_cfg;
+            client_cfg.timestamps = true;
+            TCPConfig server_cfg;
+            server_cfg.timestamps = server_timestamps;
+            TCPConnection client{client_cfg};
+            TCPConnection server{server_cfg};
+
+            client.tick(5);
+            client.connect();
+            const TCPSegment syn = pop_segment(client);
+            test_err_if(not (syn.header().timestamps == TCPHeader::Timestamps{5, 0}),
+                        "the SYN should offer timestamps");
+
+            server.tick(100);
+            server.segment_received(syn);
+            const TCPSegment syn_ack = pop_segment(server);
+            if (not server_timestamps) {
+                test_err_if(syn_ack.header().timestamps.has_value(), "a server without timestamps should not answer");
+                client.segment_received(syn_ack);
+                test_err_if(pop_segment(client).header().timestamps.has_value(), "timestamps were not negotiated");
+                continue;
+            }
+            test_err_if(not (syn_ack.header().timestamps == TCPHeader::Timestamps{100, 5}),
+                        "the SYN/ACK should echo the SYN");
+
+            client.tick(20);
+            client.segment_received(syn_ack);
+            const TCPSegment ack = pop_segment(client);
+            test_err_if(not (ack.header().timestamps == TCPHeader::Timestamps{25, 100}),
+                        "the ACK should echo the SYN/ACK");
+            server.segment_received(ack);
+
+            // PAWS: a segment whose timestamp is older than the last one seen is an old duplicate
+            client.write("abc");
+            const TCPSegment data = pop_segment(client);
+            TCPSegment stale = data;
+            stale.header().timestamps = TCPHeader::Timestamps{24, 100};
+            server.segment_received(stale);
+            test_err_if(server.inbound_stream().buffer_size() != 0, "a segment failing PAWS should be discarded");
+            test_err_if(pop_segment(server).header().ackno != syn.header().seqno + 1, "and answered with an ACK");
+
+            server.segment_received(data);
+            test_err_if(server.inbound_stream().buffer_size() != 3, "the current segment should be accepted");
+            test_err_if(not (pop_segment(server).header().timestamps == TCPHeader::Timestamps{100, 25}),
+                        "the ACK should echo the segment that advanced the ackno");
+        }
+
+        {
+            // the timestamps option counts against the MSS: a full segment, options included, still fits it
+            TCPConfig cfg;
+            cfg.timestamps = true;
+            cfg.mss = 536;
+            TCPConnection client{cfg};
+            TCPConnection server{cfg};
+            handshake(client, server);
+
+            for (TCPConnection *sender : {&client, &server}) {
+                sender->write(string(2000, 'x'));
+                const TCPSegment full = pop_segment(*sender);
+                const size_t options = full.header().length() - TCPHeader::LENGTH;
+                test_err_if(not full.header().timestamps.has_value(), "the segment should carry timestamps");
+                test_err_if(full.payload().size() + options > cfg.mss, "payload and options should fit the MSS");
+                test_err_if(full.payload().size() != cfg.mss - TCPHeader::TIMESTAMPS_LENGTH,
+                            "the payload should fill what the options leave");
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
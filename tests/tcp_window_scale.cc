@@ -0,0 +1,76 @@
+#include "tcp_config.hh"
+#include "tcp_connection.hh"
+#include "tcp_connection_test_helpers.hh"
+#include "tcp_header.hh"
+#include "tcp_segment.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        {
+            // the option survives serializing and parsing, next to the other SYN options
+            TCPSegment seg;
+            seg.header().syn = true;
+            seg.header().mss = 1460;
+            seg.header().window_scale = 7;
+            seg.header().sack_permitted = true;
+            test_err_if(seg.header().length() != TCPHeader::LENGTH + 12,
+                        "MSS, window scale and SACK-permitted take 3 words");
+
+            TCPSegment parsed;
+            test_err_if(parsed.parse(seg.serialize().concatenate()) != ParseResult::NoError, "parse failed");
+            test_err_if(parsed.header().window_scale != optional<uint8_t>{7}, "window scale option was lost");
+            test_err_if(parsed.header().mss != optional<uint16_t>{1460}, "MSS option was lost");
+        }
+
+        for (const bool server_scales : {true, false}) {
+            constexpr size_t CAPACITY = 1'000'000;
+            TCPConfig client_cfg;
+            client_cfg.window_scaling = true;
+            client_cfg.send_capacity = client_cfg.recv_capacity = CAPACITY;
+            TCPConfig server_cfg = client_cfg;
+            server_cfg.window_scaling = server_scales;
+            TCPConnection client{client_cfg};
+            TCPConnection server{server_cfg};
+
+            client.connect();
+            const TCPSegment syn = pop_segment(client);
+            // 1'000'000 >> 4 is the first shift that fits in 16 bits
+            test_err_if(syn.header().window_scale != optional<uint8_t>{4},
+                        "the SYN should offer the smallest shift that fits");
+            server.segment_received(syn);
+            const TCPSegment syn_ack = pop_segment(server);
+            test_err_if(syn_ack.header().window_scale.has_value() != server_scales,
+                        "the SYN/ACK should answer the offer only if the server scales too");
+            test_err_if(syn_ack.header().win != UINT16_MAX, "the window in a SYN is never scaled");
+            client.segment_received(syn_ack);
+            const TCPSegment ack = pop_segment(client);
+            test_err_if(ack.header().win != (server_scales ? CAPACITY >> 4 : UINT16_MAX),
+                        "after the handshake, the client should advertise its scaled window");
+            server.segment_received(ack);
+
+            server.write(string(500'000, 'x'));
+            size_t sent = 0;
+            while (not server.segments_out().empty()) {
+                sent += pop_segment(server).payload().size();
+            }
+            test_err_if(server.bytes_in_flight() != sent, "everything sent is in flight");
+            if (server_scales) {
+                test_err_if(sent != 500'000, "a scaled window should let the whole write be in flight at once");
+            } else {
+                test_err_if(sent != UINT16_MAX, "without scaling, the window stops at 64 KiB");
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
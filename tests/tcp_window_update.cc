@@ -0,0 +1,63 @@
+#include "tcp_config.hh"
+#include "tcp_connection.hh"
+#include "tcp_connection_test_helpers.hh"
+#include "tcp_segment.hh"
+#include "test_err_if.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        TCPConfig server_cfg;
+        server_cfg.recv_capacity = 4000;
+        TCPConnection client{TCPConfig{}};
+        TCPConnection server{server_cfg};
+
+        handshake(client, server);
+
+        // fill the server's window
+        client.write(string(4000, 'x'));
+        while (not client.segments_out().empty()) {
+            server.segment_received(pop_segment(client));
+        }
+        TCPSegment ack;
+        while (not server.segments_out().empty()) {
+            ack = pop_segment(server);
+        }
+        test_err_if(ack.header().win != 0, "the window should be closed");
+        client.segment_received(ack);
+
+        // reads smaller than an MSS would only advertise a silly window
+        server.inbound_stream().pop_output(500);
+        server.check_window_update();
+        server.tick(1);
+        test_err_if(not server.segments_out().empty(), "500 bytes of space is too little to advertise");
+
+        server.inbound_stream().pop_output(600);
+        server.check_window_update();
+        const TCPSegment update = pop_segment(server);
+        test_err_if(not update.header().ack or update.header().win != 1100, "the read should open the window at once");
+        test_err_if(update.length_in_sequence_space() != 0, "a window update carries no data");
+        server.check_window_update();
+        test_err_if(not server.segments_out().empty(), "the same window should not be advertised twice");
+
+        // the sender can go on without waiting for a window probe
+        client.segment_received(update);
+        client.write(string(3000, 'y'));
+        test_err_if(client.bytes_in_flight() != 1100, "the sender should fill the opened window");
+
+        // tick() notices reads the owner did not report
+        server.inbound_stream().pop_output(2900);
+        server.tick(1);
+        test_err_if(pop_segment(server).header().win != 4000, "tick should send the window update");
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+#include "tcp_config.hh"
+#include "tcp_connection.hh"
+#include "test_err_if.hh"
+#include "timer_wheel.hh"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main() {
+    try {
+        {
+            TimerWheel wheel{1000};
+            wheel.schedule(1, 1005);
+            wheel.schedule(2, 1000 + 70);            // level 1
+            wheel.schedule(3, 1000 + 5000);          // level 2
+            wheel.schedule(4, 1000 + (1ULL << 30));  // beyond the top level
+            wheel.schedule(5, 900);                  // already due
+            test_err_if(wheel.size() != 5, "five timers should be running");
+            test_err_if(wheel.next_wakeup() != optional<uint64_t>{1000}, "a due timer needs a wakeup now");
+
+            test_err_if(wheel.advance(1004) != vector<uint64_t>{5}, "only the past deadline should expire");
+            test_err_if(wheel.advance(1005) != vector<uint64_t>{1}, "a timer should expire at its deadline");
+            test_err_if(not wheel.advance(1069).empty(), "nothing is due before 1070");
+            test_err_if(wheel.advance(1070) != vector<uint64_t>{2}, "a level-1 timer should expire on time");
+
+            test_err_if(not wheel.cancel(3) or wheel.cancel(3), "cancel should stop a running timer once");
+            wheel.schedule(4, 2000);
+            test_err_if(wheel.deadline(4) != optional<uint64_t>{2000}, "rescheduling should move the deadline");
+            test_err_if(wheel.advance(1'000'000) != vector<uint64_t>{4}, "the rescheduled timer should expire");
+            test_err_if(wheel.size() != 0 or wheel.next_wakeup().has_value(), "the wheel should be empty");
+        }
+
+        {
+            // random schedules, reschedules, cancels and advances, against a plain map of deadlines
+            mt19937 rd{42};
+            TimerWheel wheel{0};
+            map<uint64_t, uint64_t> deadlines;  // key -> deadline
+            uint64_t now = 0;
+            for (unsigned step = 0; step < 20'000; step++) {
+                const unsigned action = rd() % 10;
+                const uint64_t key = rd() % 500;
+                if (action < 5) {
+                    // mostly short timers, sometimes very long ones
+                    const uint64_t span = (rd() % 8 == 0) ? (1ULL << 26) : 3000;
+                    const uint64_t deadline = now + rd() % span;
+                    wheel.schedule(key, deadline);
+                    deadlines[key] = deadline;
+                } else if (action < 6) {
+                    test_err_if(wheel.cancel(key) != (deadlines.erase(key) == 1), "cancel should match the reference");
+                } else {
+                    now += (rd() % 4 == 0) ? rd() % 100'000 : rd() % 50;
+                    vector<uint64_t> expired = wheel.advance(now);
+                    vector<uint64_t> expected;
+                    for (auto it = deadlines.begin(); it != deadlines.end();) {
+                        if (it->second <= now) {
+                            expected.push_back(it->first);
+                            it = deadlines.erase(it);
+                        } else {
+                            ++it;
+                        }
+                    }
+                    sort(expired.begin(), expired.end());
+                    test_err_if(expired != expected, "advance should expire exactly the timers that are due");
+                }
+                test_err_if(wheel.size() != deadlines.size(), "the wheel should hold every running timer");
+            }
+        }
+
+        {
+            // a host of many idle connections ticks only those whose timers expire
+            constexpr size_t N = 1000;
+            vector<TCPConnection> connections;
+            connections.reserve(N);
+            vector<uint64_t> last_tick(N, 0);
+            TimerWheel wheel{0};
+            for (size_t i = 0; i < N; i++) {
+                connections.emplace_back(TCPConfig{});
+                connections[i].connect();
+                connections[i].segments_out().pop();
+                test_err_if(connections[i].next_timeout() != optional<size_t>{TCPConfig::TIMEOUT_DFLT},
+                            "the deadline should be the retransmission timeout");
+                wheel.schedule(i, connections[i].next_timeout().value());
+            }
+
+            size_t ticked = 0;
+            for (uint64_t now = 10; now <= 3000; now += 10) {
+                for (const uint64_t i : wheel.advance(now)) {
+                    connections[i].tick(now - last_tick[i]);
+                    last_tick[i] = now;
+                    ticked++;
+                    test_err_if(connections[i].segments_out().size() != 1,
+                                "an expired connection should resend its SYN");
+                    connections[i].segments_out().pop();
+                    wheel.schedule(i, now + connections[i].next_timeout().value());
+                }
+            }
+            // every connection retransmitted at 1000 ms, then backed off and retransmitted again at 3000 ms
+            test_err_if(ticked != 2 * N, "each connection should be ticked only when its timer expires");
+            test_err_if(wheel.deadline(0) != optional<uint64_t>{7000}, "the next deadline is after a 4 s backoff");
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}